@@ -1,11 +1,17 @@
 #include "builtins/declarations.h"
 
+#include "builtins/modules/arrays.h"
 #include "builtins/modules/console.h"
+#include "builtins/modules/maps.h"
+#include "builtins/modules/sets.h"
 #include "builtins/modules/types.h"
 
 namespace Builtins {
   inline const std::vector<BuiltinModuleDeclarations> declarations = {
     Console::declarations,
     Types::declarations,
+    Maps::declarations,
+    Sets::declarations,
+    Arrays::declarations,
   };
 }
@@ -1,14 +1,14 @@
 #include "builtins/declarations.h"
 
 namespace Builtins {
-  ConstantBuiltinDeclaration::ConstantBuiltinDeclaration(std::string name, Runtime::Value* value) {
+  ConstantBuiltinDeclaration::ConstantBuiltinDeclaration(std::string name, Runtime::TaggedValue value) {
     this->name = name;
     this->value = value;
   }
   std::string ConstantBuiltinDeclaration::getName() {
     return this->name;
   }
-  Runtime::Value* ConstantBuiltinDeclaration::getValue() {
+  Runtime::TaggedValue ConstantBuiltinDeclaration::getValue() {
     return this->value;
   }
 
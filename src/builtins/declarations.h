@@ -15,13 +15,13 @@ namespace Builtins {
   class ConstantBuiltinDeclaration: public BuiltinDeclaration {
     private:
       std::string name;
-      Runtime::Value* value;
+      Runtime::TaggedValue value;
 
     public:
-      ConstantBuiltinDeclaration(std::string name, Runtime::Value* value);
+      ConstantBuiltinDeclaration(std::string name, Runtime::TaggedValue value);
   
       std::string getName();
-      Runtime::Value* getValue();
+      Runtime::TaggedValue getValue();
   };
 
   // functions
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "builtins/declarations.h"
+
+#include "runtime/arrays.h"
+#include "runtime/exceptions.h"
+#include "runtime/memory.h"
+#include "runtime/types.h"
+#include "shared/classes.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// module to work with typed numeric arrays
+// operations are performed by vectorized kernels over unboxed items
+// elementwise operations and prefix sum return new arrays, axpy and scale modify the array in place
+
+namespace Builtins {
+  namespace Arrays {
+    // elementwise kernels of both array types
+    typedef void (*Float64Kernel)(const double*, const double*, double*, int);
+    typedef void (*Int64Kernel)(const int64_t*, const int64_t*, int64_t*, int);
+
+    inline bool isArray(Runtime::TaggedValue argument) {
+      return argument.getType() == Runtime::DataType::Float64Array || argument.getType() == Runtime::DataType::Int64Array;
+    }
+    inline Runtime::Float64ArrayValue* getFloat64Array(Runtime::TaggedValue argument) {
+      return Shared::Classes::cast<Runtime::Value, Runtime::Float64ArrayValue>(argument.getPointer());
+    }
+    inline Runtime::Int64ArrayValue* getInt64Array(Runtime::TaggedValue argument) {
+      return Shared::Classes::cast<Runtime::Value, Runtime::Int64ArrayValue>(argument.getPointer());
+    }
+    inline int getArraySize(Runtime::TaggedValue argument) {
+      if (argument.getType() == Runtime::DataType::Float64Array) return getFloat64Array(argument)->getItems().getSize();
+      return getInt64Array(argument)->getItems().getSize();
+    }
+
+    inline void validateArray(Runtime::TaggedValue argument) {
+      if (!isArray(argument)) throw Runtime::Exception("Invalid type is given");
+    }
+    // binary operations require arrays of the same type and size
+    inline void validateArraysPair(Runtime::TaggedValue left, Runtime::TaggedValue right) {
+      validateArray(left);
+      validateArray(right);
+
+      if (left.getType() != right.getType()) throw Runtime::Exception("Arrays have different types");
+      if (getArraySize(left) != getArraySize(right)) throw Runtime::Exception("Arrays have different sizes");
+    }
+    inline double getNumberArgument(Runtime::TaggedValue argument) {
+      if (!argument.isNumber()) throw Runtime::Exception("Invalid type is given");
+      return argument.getNumber();
+    }
+    inline int64_t getIntegerArgument(Runtime::TaggedValue argument) {
+      double number = getNumberArgument(argument);
+
+      // range is checked before conversion (2^63 is exactly representable)
+      if (number != std::floor(number) || number < -9223372036854775808.0 || number >= 9223372036854775808.0) {
+        throw Runtime::Exception("Number is not a 64-bit integer");
+      }
+
+      return (int64_t)number;
+    }
+    inline int getIndexArgument(Runtime::TaggedValue argument, int size) {
+      double index = getNumberArgument(argument);
+      if (index != std::floor(index) || index < 0 || index >= size) throw Runtime::Exception("Index is out of range");
+
+      return index;
+    }
+
+    // creates array of given size (zeroed) or with items of vector
+    inline Runtime::TaggedValue createFloat64Array(Runtime::TaggedValue argument) {
+      if (argument.getType() != Runtime::DataType::Vector) {
+        double size = getNumberArgument(argument);
+        if (size != std::floor(size) || size < 0 || size > INT32_MAX) throw Runtime::Exception("Invalid array size");
+
+        return Runtime::TaggedValue::fromPointer(new Runtime::Float64ArrayValue(size));
+      }
+
+      Runtime::VectorValue* vector = Shared::Classes::cast<Runtime::Value, Runtime::VectorValue>(argument.getPointer());
+      Runtime::Float64ArrayValue* array = new Runtime::Float64ArrayValue(vector->getSize());
+      double* items = array->getItems().getData();
+
+      // numbers vector is already unboxed
+      if (vector->getKind() == Runtime::VectorKind::Numbers) {
+        if (vector->getSize() > 0) std::memcpy(items, vector->getNumbers().data(), vector->getSize() * sizeof(double));
+        return Runtime::TaggedValue::fromPointer(array);
+      }
+
+      for (int i = 0; i < vector->getSize(); i++) {
+        if (!vector->getItem(i).isNumber()) {
+          delete array;
+          throw Runtime::Exception("Invalid type is given");
+        }
+
+        items[i] = vector->getItem(i).getNumber();
+      }
+
+      return Runtime::TaggedValue::fromPointer(array);
+    }
+    inline Runtime::TaggedValue createInt64Array(Runtime::TaggedValue argument) {
+      if (argument.getType() != Runtime::DataType::Vector) {
+        double size = getNumberArgument(argument);
+        if (size != std::floor(size) || size < 0 || size > INT32_MAX) throw Runtime::Exception("Invalid array size");
+
+        return Runtime::TaggedValue::fromPointer(new Runtime::Int64ArrayValue(size));
+      }
+
+      Runtime::VectorValue* vector = Shared::Classes::cast<Runtime::Value, Runtime::VectorValue>(argument.getPointer());
+      Runtime::Int64ArrayValue* array = new Runtime::Int64ArrayValue(vector->getSize());
+      int64_t* items = array->getItems().getData();
+
+      for (int i = 0; i < vector->getSize(); i++) {
+        try {
+          items[i] = getIntegerArgument(vector->getItem(i));
+        } catch (...) {
+          delete array;
+          throw;
+        }
+      }
+
+      return Runtime::TaggedValue::fromPointer(array);
+    }
+
+    // returns new array with results of elementwise kernel
+    inline Runtime::TaggedValue applyElementwiseKernel(Runtime::TaggedValue left, Runtime::TaggedValue right, Float64Kernel float64Kernel, Int64Kernel int64Kernel) {
+      validateArraysPair(left, right);
+      int size = getArraySize(left);
+
+      if (left.getType() == Runtime::DataType::Float64Array) {
+        Runtime::Float64ArrayValue* result = new Runtime::Float64ArrayValue(size);
+        float64Kernel(getFloat64Array(left)->getItems().getData(), getFloat64Array(right)->getItems().getData(), result->getItems().getData(), size);
+        return Runtime::TaggedValue::fromPointer(result);
+      }
+
+      Runtime::Int64ArrayValue* result = new Runtime::Int64ArrayValue(size);
+      int64Kernel(getInt64Array(left)->getItems().getData(), getInt64Array(right)->getItems().getData(), result->getItems().getData(), size);
+      return Runtime::TaggedValue::fromPointer(result);
+    }
+
+    // Float64ArrayValue* _builtins_arrays_float64(number | VectorValue*)
+    inline const std::string float64Name = "_builtins_arrays_float64";
+    inline const Runtime::FunctionArgumentsAmount float64Arguments(1);
+    inline Runtime::TaggedValue float64Callable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return createFloat64Array(arguments[0]);
+    }
+    inline FunctionBuiltinDeclaration float64Declaration(float64Name, float64Callable, float64Arguments);
+
+    // Int64ArrayValue* _builtins_arrays_int64(number | VectorValue*)
+    inline const std::string int64Name = "_builtins_arrays_int64";
+    inline const Runtime::FunctionArgumentsAmount int64Arguments(1);
+    inline Runtime::TaggedValue int64Callable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return createInt64Array(arguments[0]);
+    }
+    inline FunctionBuiltinDeclaration int64Declaration(int64Name, int64Callable, int64Arguments);
+
+    // number _builtins_arrays_size(Array*)
+    inline const std::string sizeName = "_builtins_arrays_size";
+    inline const Runtime::FunctionArgumentsAmount sizeArguments(1);
+    inline Runtime::TaggedValue sizeCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      return Runtime::TaggedValue::fromNumber(getArraySize(arguments[0]));
+    }
+    inline FunctionBuiltinDeclaration sizeDeclaration(sizeName, sizeCallable, sizeArguments);
+
+    // number _builtins_arrays_get(Array*, number)
+    inline const std::string getName = "_builtins_arrays_get";
+    inline const Runtime::FunctionArgumentsAmount getArguments(2);
+    inline Runtime::TaggedValue getCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int index = getIndexArgument(arguments[1], getArraySize(arguments[0]));
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        return Runtime::TaggedValue::fromNumber(getFloat64Array(arguments[0])->getItems().getData()[index]);
+      }
+
+      return Runtime::TaggedValue::fromNumber(getInt64Array(arguments[0])->getItems().getData()[index]);
+    }
+    inline FunctionBuiltinDeclaration getDeclaration(getName, getCallable, getArguments);
+
+    // Array* _builtins_arrays_set(Array*, number, number)
+    // returns the array
+    inline const std::string setName = "_builtins_arrays_set";
+    inline const Runtime::FunctionArgumentsAmount setArguments(3);
+    inline Runtime::TaggedValue setCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int index = getIndexArgument(arguments[1], getArraySize(arguments[0]));
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        getFloat64Array(arguments[0])->getItems().getData()[index] = getNumberArgument(arguments[2]);
+      } else {
+        getInt64Array(arguments[0])->getItems().getData()[index] = getIntegerArgument(arguments[2]);
+      }
+
+      return arguments[0];
+    }
+    inline FunctionBuiltinDeclaration setDeclaration(setName, setCallable, setArguments);
+
+    // VectorValue* _builtins_arrays_vector(Array*)
+    inline const std::string vectorName = "_builtins_arrays_vector";
+    inline const Runtime::FunctionArgumentsAmount vectorArguments(1);
+    inline Runtime::TaggedValue vectorCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int size = getArraySize(arguments[0]);
+
+      // vector of numbers keeps items packed
+      Runtime::VectorValue* vector = new Runtime::VectorValue({});
+      vector->reserve(size);
+
+      for (int i = 0; i < size; i++) {
+        if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+          vector->push(Runtime::TaggedValue::fromNumber(getFloat64Array(arguments[0])->getItems().getData()[i]));
+        } else {
+          vector->push(Runtime::TaggedValue::fromNumber(getInt64Array(arguments[0])->getItems().getData()[i]));
+        }
+      }
+
+      return Runtime::TaggedValue::fromPointer(vector);
+    }
+    inline FunctionBuiltinDeclaration vectorDeclaration(vectorName, vectorCallable, vectorArguments);
+
+    // number _builtins_arrays_sum(Array*)
+    inline const std::string sumName = "_builtins_arrays_sum";
+    inline const Runtime::FunctionArgumentsAmount sumArguments(1);
+    inline Runtime::TaggedValue sumCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int size = getArraySize(arguments[0]);
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        return Runtime::TaggedValue::fromNumber(Runtime::sumFloat64(getFloat64Array(arguments[0])->getItems().getData(), size));
+      }
+
+      return Runtime::TaggedValue::fromNumber(Runtime::sumInt64(getInt64Array(arguments[0])->getItems().getData(), size));
+    }
+    inline FunctionBuiltinDeclaration sumDeclaration(sumName, sumCallable, sumArguments);
+
+    // number _builtins_arrays_min(Array*)
+    // returns null for empty array
+    inline const std::string minName = "_builtins_arrays_min";
+    inline const Runtime::FunctionArgumentsAmount minArguments(1);
+    inline Runtime::TaggedValue minCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int size = getArraySize(arguments[0]);
+      if (size == 0) return Runtime::TaggedValue();
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        return Runtime::TaggedValue::fromNumber(Runtime::minFloat64(getFloat64Array(arguments[0])->getItems().getData(), size));
+      }
+
+      return Runtime::TaggedValue::fromNumber(Runtime::minInt64(getInt64Array(arguments[0])->getItems().getData(), size));
+    }
+    inline FunctionBuiltinDeclaration minDeclaration(minName, minCallable, minArguments);
+
+    // number _builtins_arrays_max(Array*)
+    // returns null for empty array
+    inline const std::string maxName = "_builtins_arrays_max";
+    inline const Runtime::FunctionArgumentsAmount maxArguments(1);
+    inline Runtime::TaggedValue maxCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int size = getArraySize(arguments[0]);
+      if (size == 0) return Runtime::TaggedValue();
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        return Runtime::TaggedValue::fromNumber(Runtime::maxFloat64(getFloat64Array(arguments[0])->getItems().getData(), size));
+      }
+
+      return Runtime::TaggedValue::fromNumber(Runtime::maxInt64(getInt64Array(arguments[0])->getItems().getData(), size));
+    }
+    inline FunctionBuiltinDeclaration maxDeclaration(maxName, maxCallable, maxArguments);
+
+    // number _builtins_arrays_dot(Array*, Array*)
+    inline const std::string dotName = "_builtins_arrays_dot";
+    inline const Runtime::FunctionArgumentsAmount dotArguments(2);
+    inline Runtime::TaggedValue dotCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArraysPair(arguments[0], arguments[1]);
+      int size = getArraySize(arguments[0]);
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        double* left = getFloat64Array(arguments[0])->getItems().getData();
+        double* right = getFloat64Array(arguments[1])->getItems().getData();
+        return Runtime::TaggedValue::fromNumber(Runtime::dotFloat64(left, right, size));
+      }
+
+      int64_t* left = getInt64Array(arguments[0])->getItems().getData();
+      int64_t* right = getInt64Array(arguments[1])->getItems().getData();
+      return Runtime::TaggedValue::fromNumber(Runtime::dotInt64(left, right, size));
+    }
+    inline FunctionBuiltinDeclaration dotDeclaration(dotName, dotCallable, dotArguments);
+
+    // Array* _builtins_arrays_axpy(number, Array*, Array*)
+    // computes y = alpha * x + y, returns y
+    inline const std::string axpyName = "_builtins_arrays_axpy";
+    inline const Runtime::FunctionArgumentsAmount axpyArguments(3);
+    inline Runtime::TaggedValue axpyCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArraysPair(arguments[1], arguments[2]);
+      int size = getArraySize(arguments[1]);
+
+      if (arguments[1].getType() == Runtime::DataType::Float64Array) {
+        double alpha = getNumberArgument(arguments[0]);
+        Runtime::axpyFloat64(alpha, getFloat64Array(arguments[1])->getItems().getData(), getFloat64Array(arguments[2])->getItems().getData(), size);
+      } else {
+        int64_t alpha = getIntegerArgument(arguments[0]);
+        Runtime::axpyInt64(alpha, getInt64Array(arguments[1])->getItems().getData(), getInt64Array(arguments[2])->getItems().getData(), size);
+      }
+
+      return arguments[2];
+    }
+    inline FunctionBuiltinDeclaration axpyDeclaration(axpyName, axpyCallable, axpyArguments);
+
+    // Array* _builtins_arrays_add(Array*, Array*)
+    inline const std::string addName = "_builtins_arrays_add";
+    inline const Runtime::FunctionArgumentsAmount addArguments(2);
+    inline Runtime::TaggedValue addCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return applyElementwiseKernel(arguments[0], arguments[1], Runtime::addFloat64, Runtime::addInt64);
+    }
+    inline FunctionBuiltinDeclaration addDeclaration(addName, addCallable, addArguments);
+
+    // Array* _builtins_arrays_subtract(Array*, Array*)
+    inline const std::string subtractName = "_builtins_arrays_subtract";
+    inline const Runtime::FunctionArgumentsAmount subtractArguments(2);
+    inline Runtime::TaggedValue subtractCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return applyElementwiseKernel(arguments[0], arguments[1], Runtime::subtractFloat64, Runtime::subtractInt64);
+    }
+    inline FunctionBuiltinDeclaration subtractDeclaration(subtractName, subtractCallable, subtractArguments);
+
+    // Array* _builtins_arrays_multiply(Array*, Array*)
+    inline const std::string multiplyName = "_builtins_arrays_multiply";
+    inline const Runtime::FunctionArgumentsAmount multiplyArguments(2);
+    inline Runtime::TaggedValue multiplyCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return applyElementwiseKernel(arguments[0], arguments[1], Runtime::multiplyFloat64, Runtime::multiplyInt64);
+    }
+    inline FunctionBuiltinDeclaration multiplyDeclaration(multiplyName, multiplyCallable, multiplyArguments);
+
+    // Array* _builtins_arrays_divide(Array*, Array*)
+    // int64 division truncates and fails on zero divisor
+    inline const std::string divideName = "_builtins_arrays_divide";
+    inline const Runtime::FunctionArgumentsAmount divideArguments(2);
+    inline Runtime::TaggedValue divideCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArraysPair(arguments[0], arguments[1]);
+
+      if (arguments[1].getType() == Runtime::DataType::Int64Array) {
+        int64_t* divisors = getInt64Array(arguments[1])->getItems().getData();
+        for (int i = 0; i < getArraySize(arguments[1]); i++) {
+          if (divisors[i] == 0) throw Runtime::Exception("Division by zero");
+        }
+      }
+
+      return applyElementwiseKernel(arguments[0], arguments[1], Runtime::divideFloat64, Runtime::divideInt64);
+    }
+    inline FunctionBuiltinDeclaration divideDeclaration(divideName, divideCallable, divideArguments);
+
+    // Array* _builtins_arrays_scale(Array*, number)
+    // multiplies items in place, returns the array
+    inline const std::string scaleName = "_builtins_arrays_scale";
+    inline const Runtime::FunctionArgumentsAmount scaleArguments(2);
+    inline Runtime::TaggedValue scaleCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int size = getArraySize(arguments[0]);
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        Runtime::scaleFloat64(getNumberArgument(arguments[1]), getFloat64Array(arguments[0])->getItems().getData(), size);
+      } else {
+        Runtime::scaleInt64(getIntegerArgument(arguments[1]), getInt64Array(arguments[0])->getItems().getData(), size);
+      }
+
+      return arguments[0];
+    }
+    inline FunctionBuiltinDeclaration scaleDeclaration(scaleName, scaleCallable, scaleArguments);
+
+    // Array* _builtins_arrays_prefix_sum(Array*)
+    // item i of result is sum of items 0..i
+    inline const std::string prefixSumName = "_builtins_arrays_prefix_sum";
+    inline const Runtime::FunctionArgumentsAmount prefixSumArguments(1);
+    inline Runtime::TaggedValue prefixSumCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateArray(arguments[0]);
+      int size = getArraySize(arguments[0]);
+
+      if (arguments[0].getType() == Runtime::DataType::Float64Array) {
+        Runtime::Float64ArrayValue* result = new Runtime::Float64ArrayValue(size);
+        Runtime::prefixSumFloat64(getFloat64Array(arguments[0])->getItems().getData(), result->getItems().getData(), size);
+        return Runtime::TaggedValue::fromPointer(result);
+      }
+
+      Runtime::Int64ArrayValue* result = new Runtime::Int64ArrayValue(size);
+      Runtime::prefixSumInt64(getInt64Array(arguments[0])->getItems().getData(), result->getItems().getData(), size);
+      return Runtime::TaggedValue::fromPointer(result);
+    }
+    inline FunctionBuiltinDeclaration prefixSumDeclaration(prefixSumName, prefixSumCallable, prefixSumArguments);
+
+    // all declarations
+    inline const BuiltinModuleDeclarations declarations = {
+      &float64Declaration,
+      &int64Declaration,
+      &sizeDeclaration,
+      &getDeclaration,
+      &setDeclaration,
+      &vectorDeclaration,
+      &sumDeclaration,
+      &minDeclaration,
+      &maxDeclaration,
+      &dotDeclaration,
+      &axpyDeclaration,
+      &addDeclaration,
+      &subtractDeclaration,
+      &multiplyDeclaration,
+      &divideDeclaration,
+      &scaleDeclaration,
+      &prefixSumDeclaration,
+    };
+  }
+}
@@ -12,22 +12,22 @@ namespace Builtins {
     // StringValue* _builtins_console_input();
     inline const std::string inputName = "_builtins_console_input";
     inline const Runtime::FunctionArgumentsAmount inputArgumentsAmount(0);
-    inline Runtime::StringValue* inputCallable(std::vector<Runtime::Value*>) {
+    inline Runtime::TaggedValue inputCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue>) {
       std::string raw = "";
       std::cin >> raw;
 
       Runtime::StringValue* value = new Runtime::StringValue(raw);
-      return value;
+      return Runtime::TaggedValue::fromPointer(value);
     };
     inline Builtins::FunctionBuiltinDeclaration inputDeclaration(inputName, inputCallable, inputArgumentsAmount);
 
     // void _builtins_console_output(StringValue*);
     inline const std::string outputName = "_builtins_console_output";
     inline const Runtime::FunctionArgumentsAmount outputArgumentsAmount(1);
-    inline Runtime::NullValue* outputCallable(std::vector<Runtime::Value*> arguments) {
-      Runtime::Value* outputArgument = arguments[0];
+    inline Runtime::TaggedValue outputCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue outputArgument = arguments[0];
       std::cout << Runtime::StringValue::getDataOf(outputArgument);
-      return new Runtime::NullValue;
+      return Runtime::TaggedValue();
     };
     inline Builtins::FunctionBuiltinDeclaration outputDeclaration(outputName, outputCallable, outputArgumentsAmount);
   
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "builtins/declarations.h"
+
+#include "runtime/exceptions.h"
+#include "runtime/memory.h"
+#include "runtime/types.h"
+#include "shared/classes.h"
+
+// module to work with hash maps
+// maps retain their keys and values, so stored values live as long as the map refers to them
+
+namespace Builtins {
+  namespace Maps {
+    inline Runtime::MapValue* getMapArgument(Runtime::TaggedValue argument) {
+      if (argument.getType() != Runtime::DataType::Map) throw Runtime::Exception("Invalid type is given");
+      return Shared::Classes::cast<Runtime::Value, Runtime::MapValue>(argument.getPointer());
+    }
+
+    // MapValue* _builtins_maps_create()
+    inline const std::string createName = "_builtins_maps_create";
+    inline const Runtime::FunctionArgumentsAmount createArguments(0);
+    inline Runtime::TaggedValue createCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue>) {
+      return Runtime::TaggedValue::fromPointer(new Runtime::MapValue());
+    }
+    inline FunctionBuiltinDeclaration createDeclaration(createName, createCallable, createArguments);
+
+    // MapValue* _builtins_maps_set(MapValue*, Value*, Value*)
+    // returns the map
+    inline const std::string setName = "_builtins_maps_set";
+    inline const Runtime::FunctionArgumentsAmount setArguments(3);
+    inline Runtime::TaggedValue setCallable(Runtime::Memory& memory, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::HashTable& table = getMapArgument(arguments[0])->getTable();
+
+      // new value is retained before the previous one is released (they can be the same value)
+      Runtime::TaggedValue* value = table.find(arguments[1]);
+      if (value != NULL) {
+        Runtime::TaggedValue storedValue = memory.retainValue(arguments[2]);
+        memory.releaseValue(*value);
+        *value = storedValue;
+      } else {
+        table.insert(memory.retainValue(arguments[1]), memory.retainValue(arguments[2]));
+      }
+
+      return arguments[0];
+    }
+    inline FunctionBuiltinDeclaration setDeclaration(setName, setCallable, setArguments);
+
+    // Value* _builtins_maps_get(MapValue*, Value*)
+    // returns null if key is not found
+    inline const std::string getName = "_builtins_maps_get";
+    inline const Runtime::FunctionArgumentsAmount getArguments(2);
+    inline Runtime::TaggedValue getCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue* value = getMapArgument(arguments[0])->getTable().find(arguments[1]);
+      if (value == NULL) return Runtime::TaggedValue();
+
+      return *value;
+    }
+    inline FunctionBuiltinDeclaration getDeclaration(getName, getCallable, getArguments);
+
+    // boolean _builtins_maps_has(MapValue*, Value*)
+    inline const std::string hasName = "_builtins_maps_has";
+    inline const Runtime::FunctionArgumentsAmount hasArguments(2);
+    inline Runtime::TaggedValue hasCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return Runtime::TaggedValue::fromBoolean(getMapArgument(arguments[0])->getTable().has(arguments[1]));
+    }
+    inline FunctionBuiltinDeclaration hasDeclaration(hasName, hasCallable, hasArguments);
+
+    // boolean _builtins_maps_delete(MapValue*, Value*)
+    // returns if the entry is removed
+    inline const std::string deleteName = "_builtins_maps_delete";
+    inline const Runtime::FunctionArgumentsAmount deleteArguments(2);
+    inline Runtime::TaggedValue deleteCallable(Runtime::Memory& memory, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue removedKey;
+      Runtime::TaggedValue removedValue;
+
+      bool isRemoved = getMapArgument(arguments[0])->getTable().remove(arguments[1], removedKey, removedValue);
+      if (isRemoved) {
+        memory.releaseValue(removedKey);
+        memory.releaseValue(removedValue);
+      }
+
+      return Runtime::TaggedValue::fromBoolean(isRemoved);
+    }
+    inline FunctionBuiltinDeclaration deleteDeclaration(deleteName, deleteCallable, deleteArguments);
+
+    // number _builtins_maps_size(MapValue*)
+    inline const std::string sizeName = "_builtins_maps_size";
+    inline const Runtime::FunctionArgumentsAmount sizeArguments(1);
+    inline Runtime::TaggedValue sizeCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return Runtime::TaggedValue::fromNumber(getMapArgument(arguments[0])->getTable().getSize());
+    }
+    inline FunctionBuiltinDeclaration sizeDeclaration(sizeName, sizeCallable, sizeArguments);
+
+    // VectorValue* _builtins_maps_keys(MapValue*)
+    // keys are listed in table order
+    inline const std::string keysName = "_builtins_maps_keys";
+    inline const Runtime::FunctionArgumentsAmount keysArguments(1);
+    inline Runtime::TaggedValue keysCallable(Runtime::Memory& memory, std::vector<Runtime::TaggedValue> arguments) {
+      const Runtime::HashTable& table = getMapArgument(arguments[0])->getTable();
+
+      Runtime::VectorValue* keys = new Runtime::VectorValue({});
+      keys->reserve(table.getSize());
+
+      for (int i = 0; i < table.getEntries().size(); i++) {
+        if (!table.getEntries()[i].isEmpty()) keys->push(memory.retainValue(table.getEntries()[i].key));
+      }
+
+      return Runtime::TaggedValue::fromPointer(keys);
+    }
+    inline FunctionBuiltinDeclaration keysDeclaration(keysName, keysCallable, keysArguments);
+
+    // VectorValue* _builtins_maps_values(MapValue*)
+    // values are listed in the order of keys
+    inline const std::string valuesName = "_builtins_maps_values";
+    inline const Runtime::FunctionArgumentsAmount valuesArguments(1);
+    inline Runtime::TaggedValue valuesCallable(Runtime::Memory& memory, std::vector<Runtime::TaggedValue> arguments) {
+      const Runtime::HashTable& table = getMapArgument(arguments[0])->getTable();
+
+      Runtime::VectorValue* values = new Runtime::VectorValue({});
+      values->reserve(table.getSize());
+
+      for (int i = 0; i < table.getEntries().size(); i++) {
+        if (!table.getEntries()[i].isEmpty()) values->push(memory.retainValue(table.getEntries()[i].value));
+      }
+
+      return Runtime::TaggedValue::fromPointer(values);
+    }
+    inline FunctionBuiltinDeclaration valuesDeclaration(valuesName, valuesCallable, valuesArguments);
+
+    // all declarations
+    inline const BuiltinModuleDeclarations declarations = {
+      &createDeclaration,
+      &setDeclaration,
+      &getDeclaration,
+      &hasDeclaration,
+      &deleteDeclaration,
+      &sizeDeclaration,
+      &keysDeclaration,
+      &valuesDeclaration,
+    };
+  }
+}
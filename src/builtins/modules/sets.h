@@ -0,0 +1,100 @@
+#pragma once
+
+#include "builtins/declarations.h"
+
+#include "runtime/exceptions.h"
+#include "runtime/memory.h"
+#include "runtime/types.h"
+#include "shared/classes.h"
+
+// module to work with hash sets
+// sets retain their values
+
+namespace Builtins {
+  namespace Sets {
+    inline Runtime::SetValue* getSetArgument(Runtime::TaggedValue argument) {
+      if (argument.getType() != Runtime::DataType::Set) throw Runtime::Exception("Invalid type is given");
+      return Shared::Classes::cast<Runtime::Value, Runtime::SetValue>(argument.getPointer());
+    }
+
+    // SetValue* _builtins_sets_create()
+    inline const std::string createName = "_builtins_sets_create";
+    inline const Runtime::FunctionArgumentsAmount createArguments(0);
+    inline Runtime::TaggedValue createCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue>) {
+      return Runtime::TaggedValue::fromPointer(new Runtime::SetValue());
+    }
+    inline FunctionBuiltinDeclaration createDeclaration(createName, createCallable, createArguments);
+
+    // boolean _builtins_sets_add(SetValue*, Value*)
+    // returns if the value is added
+    inline const std::string addName = "_builtins_sets_add";
+    inline const Runtime::FunctionArgumentsAmount addArguments(2);
+    inline Runtime::TaggedValue addCallable(Runtime::Memory& memory, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::HashTable& table = getSetArgument(arguments[0])->getTable();
+      if (table.has(arguments[1])) return Runtime::TaggedValue::fromBoolean(false);
+
+      table.insert(memory.retainValue(arguments[1]), Runtime::TaggedValue());
+      return Runtime::TaggedValue::fromBoolean(true);
+    }
+    inline FunctionBuiltinDeclaration addDeclaration(addName, addCallable, addArguments);
+
+    // boolean _builtins_sets_has(SetValue*, Value*)
+    inline const std::string hasName = "_builtins_sets_has";
+    inline const Runtime::FunctionArgumentsAmount hasArguments(2);
+    inline Runtime::TaggedValue hasCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return Runtime::TaggedValue::fromBoolean(getSetArgument(arguments[0])->getTable().has(arguments[1]));
+    }
+    inline FunctionBuiltinDeclaration hasDeclaration(hasName, hasCallable, hasArguments);
+
+    // boolean _builtins_sets_delete(SetValue*, Value*)
+    // returns if the value is removed
+    inline const std::string deleteName = "_builtins_sets_delete";
+    inline const Runtime::FunctionArgumentsAmount deleteArguments(2);
+    inline Runtime::TaggedValue deleteCallable(Runtime::Memory& memory, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue removedKey;
+      Runtime::TaggedValue removedValue;
+
+      bool isRemoved = getSetArgument(arguments[0])->getTable().remove(arguments[1], removedKey, removedValue);
+      if (isRemoved) memory.releaseValue(removedKey);
+
+      return Runtime::TaggedValue::fromBoolean(isRemoved);
+    }
+    inline FunctionBuiltinDeclaration deleteDeclaration(deleteName, deleteCallable, deleteArguments);
+
+    // number _builtins_sets_size(SetValue*)
+    inline const std::string sizeName = "_builtins_sets_size";
+    inline const Runtime::FunctionArgumentsAmount sizeArguments(1);
+    inline Runtime::TaggedValue sizeCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      return Runtime::TaggedValue::fromNumber(getSetArgument(arguments[0])->getTable().getSize());
+    }
+    inline FunctionBuiltinDeclaration sizeDeclaration(sizeName, sizeCallable, sizeArguments);
+
+    // VectorValue* _builtins_sets_values(SetValue*)
+    // values are listed in table order
+    inline const std::string valuesName = "_builtins_sets_values";
+    inline const Runtime::FunctionArgumentsAmount valuesArguments(1);
+    inline Runtime::TaggedValue valuesCallable(Runtime::Memory& memory, std::vector<Runtime::TaggedValue> arguments) {
+      const Runtime::HashTable& table = getSetArgument(arguments[0])->getTable();
+
+      Runtime::VectorValue* values = new Runtime::VectorValue({});
+      values->reserve(table.getSize());
+
+      for (int i = 0; i < table.getEntries().size(); i++) {
+        if (!table.getEntries()[i].isEmpty()) values->push(memory.retainValue(table.getEntries()[i].key));
+      }
+
+      return Runtime::TaggedValue::fromPointer(values);
+    }
+    inline FunctionBuiltinDeclaration valuesDeclaration(valuesName, valuesCallable, valuesArguments);
+
+    // all declarations
+    inline const BuiltinModuleDeclarations declarations = {
+      &createDeclaration,
+      &addDeclaration,
+      &hasDeclaration,
+      &deleteDeclaration,
+      &sizeDeclaration,
+      &valuesDeclaration,
+    };
+  }
+}
@@ -18,6 +18,10 @@ namespace Builtins {
       { Runtime::DataType::String, "string" },
       { Runtime::DataType::Vector, "vector" },
       { Runtime::DataType::Object, "object" },
+      { Runtime::DataType::Map, "map" },
+      { Runtime::DataType::Set, "set" },
+      { Runtime::DataType::Float64Array, "float64array" },
+      { Runtime::DataType::Int64Array, "int64array" },
       { Runtime::DataType::Class, "class" },
       { Runtime::DataType::Function, "function" },
     };
@@ -25,43 +29,43 @@ namespace Builtins {
     // StringValue* _builtin_types_type(Value*)
     inline const std::string typeName = "_builtins_types_type";
     inline const Runtime::FunctionArgumentsAmount typeArguments(1);
-    inline Runtime::StringValue* typeCallable(std::vector<Runtime::Value*> arguments) {
-      Runtime::Value* typeArgument = arguments[0];
-      std::string type = TYPES.at(typeArgument->getType());
-      return new Runtime::StringValue(type);
+    inline Runtime::TaggedValue typeCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue typeArgument = arguments[0];
+      std::string type = TYPES.at(typeArgument.getType());
+      return Runtime::TaggedValue::fromPointer(new Runtime::StringValue(type));
     }
     inline FunctionBuiltinDeclaration typeDeclaration(typeName, typeCallable, typeArguments);
 
-    // BooleanValue* _builtin_types_boolean(Value*)
+    // boolean _builtin_types_boolean(Value*)
     inline const std::string booleanName = "_builtins_types_boolean";
     inline const Runtime::FunctionArgumentsAmount booleanArguments(1);
-    inline Runtime::BooleanValue* booleanCallable(std::vector<Runtime::Value*> arguments) {
-      Runtime::Value* booleanArgument = arguments[0];
+    inline Runtime::TaggedValue booleanCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue booleanArgument = arguments[0];
       bool result = Runtime::getBoolean(booleanArgument);
-      return new Runtime::BooleanValue(result);
+      return Runtime::TaggedValue::fromBoolean(result);
     }
     inline FunctionBuiltinDeclaration booleanDeclaration(booleanName, booleanCallable, booleanArguments);
 
-    // NumberValue* _builtin_types_number(Value*)
+    // number _builtin_types_number(Value*)
     inline const std::string numberName = "_builtins_types_number";
     inline const Runtime::FunctionArgumentsAmount numberArguments(1);
-    inline Runtime::NumberValue* numberCallable(std::vector<Runtime::Value*> arguments) {
-      Runtime::Value* numberArgument = arguments[0];
+    inline Runtime::TaggedValue numberCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue numberArgument = arguments[0];
       
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::NullValue>(numberArgument)) {
-        return new Runtime::NumberValue(0);
+      if (numberArgument.isNull()) {
+        return Runtime::TaggedValue::fromNumber(0);
       } 
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::BooleanValue>(numberArgument)) {
-        bool realValue = Runtime::BooleanValue::getDataOf(numberArgument);
-        if (realValue) return new Runtime::NumberValue(1);
-        else return new Runtime::NumberValue(0);
+      if (numberArgument.isBoolean()) {
+        bool realValue = numberArgument.getBoolean();
+        if (realValue) return Runtime::TaggedValue::fromNumber(1);
+        else return Runtime::TaggedValue::fromNumber(0);
       }
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::NumberValue>(numberArgument)) {
-        return Shared::Classes::cast<Runtime::Value, Runtime::NumberValue>(numberArgument);
+      if (numberArgument.isNumber()) {
+        return numberArgument;
       }
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::StringValue>(numberArgument)) {
-        std::string realValue = Runtime::StringValue::getDataOf(numberArgument);
-        return new Runtime::NumberValue(std::stod(realValue));
+      if (numberArgument.getType() == Runtime::DataType::String) {
+        std::string realValue(Runtime::StringValue::getDataOf(numberArgument));
+        return Runtime::TaggedValue::fromNumber(std::stod(realValue));
       }
 
       throw Runtime::Exception("Invalid type is given");
@@ -71,35 +75,105 @@ namespace Builtins {
     // StringValue* _builtin_types_string(PrimitiveValue*)
     inline const std::string stringName = "_builtins_types_string";
     inline const Runtime::FunctionArgumentsAmount stringArguments(1);
-    inline Runtime::StringValue* stringCallable(std::vector<Runtime::Value*> arguments) {
-      Runtime::Value* stringValue = arguments[0];
+    inline Runtime::TaggedValue stringCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      Runtime::TaggedValue stringValue = arguments[0];
 
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::NullValue>(stringValue)) {
-        return new Runtime::StringValue(Specification::MAP_TOKEN_TYPE_TO_STRING.at(Specification::TokenType::NULL_KEYWORD_TOKEN));
+      if (stringValue.isNull()) {
+        return Runtime::TaggedValue::fromPointer(new Runtime::StringValue(Specification::MAP_TOKEN_TYPE_TO_STRING.at(Specification::TokenType::NULL_KEYWORD_TOKEN)));
       } 
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::BooleanValue>(stringValue)) {
-        bool realValue = Runtime::BooleanValue::getDataOf(stringValue);
-        if (realValue) return new Runtime::StringValue(Specification::MAP_TOKEN_TYPE_TO_STRING.at(Specification::TokenType::TRUE_KEYWORD_TOKEN));
-        else return new Runtime::StringValue(Specification::MAP_TOKEN_TYPE_TO_STRING.at(Specification::TokenType::FALSE_KEYWORD_TOKEN));
+      if (stringValue.isBoolean()) {
+        bool realValue = stringValue.getBoolean();
+        if (realValue) return Runtime::TaggedValue::fromPointer(new Runtime::StringValue(Specification::MAP_TOKEN_TYPE_TO_STRING.at(Specification::TokenType::TRUE_KEYWORD_TOKEN)));
+        else return Runtime::TaggedValue::fromPointer(new Runtime::StringValue(Specification::MAP_TOKEN_TYPE_TO_STRING.at(Specification::TokenType::FALSE_KEYWORD_TOKEN)));
       }
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::NumberValue>(stringValue)) {
-        double realValue = Runtime::NumberValue::getDataOf(stringValue);
-        return new Runtime::StringValue(std::to_string(realValue));
+      if (stringValue.isNumber()) {
+        double realValue = stringValue.getNumber();
+        return Runtime::TaggedValue::fromPointer(new Runtime::StringValue(std::to_string(realValue)));
       }
-      if (Shared::Classes::isInstanceOf<Runtime::Value, Runtime::StringValue>(stringValue)) {
-        return Shared::Classes::cast<Runtime::Value, Runtime::StringValue>(stringValue);
+      if (stringValue.getType() == Runtime::DataType::String) {
+        return stringValue;
       }
 
       throw Runtime::Exception("Invalid type is given");
     }
     inline FunctionBuiltinDeclaration stringDeclaration(stringName, stringCallable, stringArguments);
 
+    // clamps index to string bounds (NaN is treated as zero)
+    inline size_t clampStringIndex(double index, size_t length) {
+      if (!(index > 0)) return 0;
+      if (index > length) return length;
+      return (size_t)index;
+    }
+    // validates string and index arguments of slicing functions
+    inline void validateSlicingArguments(const std::vector<Runtime::TaggedValue>& arguments) {
+      if (arguments[0].getType() != Runtime::DataType::String) throw Runtime::Exception("Invalid type is given");
+
+      for (int i = 1; i < arguments.size(); i++) {
+        if (!arguments[i].isNumber()) throw Runtime::Exception("Invalid type is given");
+      }
+    }
+
+    // StringValue* _builtins_types_substring(StringValue*, number, number?)
+    // indexes are clamped to string bounds and are swapped if start is greater than end
+    inline const std::string substringName = "_builtins_types_substring";
+    inline const Runtime::FunctionArgumentsAmount substringArguments(3, 1);
+    inline Runtime::TaggedValue substringCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateSlicingArguments(arguments);
+
+      Runtime::StringValue* string = Shared::Classes::cast<Runtime::Value, Runtime::StringValue>(arguments[0].getPointer());
+      size_t length = string->getLength();
+
+      size_t start = clampStringIndex(arguments[1].getNumber(), length);
+      size_t end = arguments.size() > 2 ? clampStringIndex(arguments[2].getNumber(), length) : length;
+      if (start > end) std::swap(start, end);
+
+      return Runtime::TaggedValue::fromPointer(new Runtime::StringValue(string->getSlice(start, end - start)));
+    }
+    inline FunctionBuiltinDeclaration substringDeclaration(substringName, substringCallable, substringArguments);
+
+    // StringValue* _builtins_types_slice(StringValue*, number, number?)
+    // negative indexes are counted from the end of string, empty string is returned if start is after end
+    inline const std::string sliceName = "_builtins_types_slice";
+    inline const Runtime::FunctionArgumentsAmount sliceArguments(3, 1);
+    inline Runtime::TaggedValue sliceCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      validateSlicingArguments(arguments);
+
+      Runtime::StringValue* string = Shared::Classes::cast<Runtime::Value, Runtime::StringValue>(arguments[0].getPointer());
+      size_t length = string->getLength();
+
+      double startIndex = arguments[1].getNumber();
+      double endIndex = arguments.size() > 2 ? arguments[2].getNumber() : length;
+
+      size_t start = clampStringIndex(startIndex < 0 ? length + startIndex : startIndex, length);
+      size_t end = clampStringIndex(endIndex < 0 ? length + endIndex : endIndex, length);
+      if (start > end) end = start;
+
+      return Runtime::TaggedValue::fromPointer(new Runtime::StringValue(string->getSlice(start, end - start)));
+    }
+    inline FunctionBuiltinDeclaration sliceDeclaration(sliceName, sliceCallable, sliceArguments);
+
+    // StringValue* _builtins_types_compact(StringValue*)
+    // copies characters of a slice to own buffer, so a small slice does not keep a large parent string alive
+    inline const std::string compactName = "_builtins_types_compact";
+    inline const Runtime::FunctionArgumentsAmount compactArguments(1);
+    inline Runtime::TaggedValue compactCallable(Runtime::Memory&, std::vector<Runtime::TaggedValue> arguments) {
+      if (arguments[0].getType() != Runtime::DataType::String) throw Runtime::Exception("Invalid type is given");
+
+      // characters are not changed, so the string is compacted in place
+      Shared::Classes::cast<Runtime::Value, Runtime::StringValue>(arguments[0].getPointer())->compact();
+      return arguments[0];
+    }
+    inline FunctionBuiltinDeclaration compactDeclaration(compactName, compactCallable, compactArguments);
+
     // all declarations
     inline const BuiltinModuleDeclarations declarations = {
       &typeDeclaration,
       &booleanDeclaration,
       &numberDeclaration,
       &stringDeclaration,
+      &substringDeclaration,
+      &sliceDeclaration,
+      &compactDeclaration,
     };
   }
 }
\ No newline at end of file
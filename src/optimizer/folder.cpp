@@ -0,0 +1,603 @@
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+#include "optimizer/folder.h"
+#include "shared/classes.h"
+
+namespace Optimizer {
+  ConstantFolder::ConstantFolder() {
+    this->scopes = {};
+  }
+
+  void ConstantFolder::fold(AST::BlockStatement* content) {
+    this->scopes = {};
+    this->foldBlockStatement(content);
+  }
+
+  void ConstantFolder::addScope() {
+    this->scopes.push_back({});
+  }
+  void ConstantFolder::removeScope() {
+    this->scopes.pop_back();
+  }
+  void ConstantFolder::declareName(std::string name, AST::LiteralExpression* constant) {
+    this->scopes.back()[name] = constant;
+  }
+  AST::LiteralExpression* ConstantFolder::getConstantByName(std::string name) {
+    // the innermost declaration shadows the outer ones
+    for (int i = this->scopes.size() - 1; i >= 0; i--) {
+      auto iterator = this->scopes[i].find(name);
+      if (iterator != this->scopes[i].end()) return iterator->second;
+    }
+
+    return NULL;
+  }
+
+  // statements
+  void ConstantFolder::foldStatement(AST::Statement* statement) {
+    if (statement == NULL) return;
+
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::BlockStatement>(statement)) {
+      return this->foldBlockStatement(Shared::Classes::cast<AST::Statement, AST::BlockStatement>(statement));
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ExpressionStatement>(statement)) {
+      AST::ExpressionStatement* expressionStatement = Shared::Classes::cast<AST::Statement, AST::ExpressionStatement>(statement);
+      expressionStatement->setExpression(this->foldExpression(expressionStatement->getExpression()));
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::VariableDeclarationStatement>(statement)) {
+      AST::VariableDeclarationStatement* declaration = Shared::Classes::cast<AST::Statement, AST::VariableDeclarationStatement>(statement);
+      declaration->setInitializer(this->foldExpression(declaration->getInitializer()));
+      this->declareName(declaration->getName().getCode(), NULL);
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ConstantDeclarationStatement>(statement)) {
+      AST::ConstantDeclarationStatement* declaration = Shared::Classes::cast<AST::Statement, AST::ConstantDeclarationStatement>(statement);
+      declaration->setInitializer(this->foldExpression(declaration->getInitializer()));
+
+      // constants initialized with literals are propagated to their usages
+      AST::LiteralExpression* constant = NULL;
+      if (Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(declaration->getInitializer())) {
+        constant = Shared::Classes::cast<AST::Expression, AST::LiteralExpression>(declaration->getInitializer());
+      }
+
+      this->declareName(declaration->getName().getCode(), constant);
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ConditionStatement>(statement)) {
+      AST::ConditionStatement* condition = Shared::Classes::cast<AST::Statement, AST::ConditionStatement>(statement);
+      condition->setCondition(this->foldExpression(condition->getCondition()));
+
+      this->foldNestedStatement(condition->getThenBranch());
+      this->foldNestedStatement(condition->getElseBranch());
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::WhileStatement>(statement)) {
+      AST::WhileStatement* loop = Shared::Classes::cast<AST::Statement, AST::WhileStatement>(statement);
+
+      // condition is evaluated after the body on next iterations
+      this->declareNestedStatementName(loop->getBody());
+      loop->setCondition(this->foldExpression(loop->getCondition()));
+      this->foldNestedStatement(loop->getBody());
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ForStatement>(statement)) {
+      AST::ForStatement* loop = Shared::Classes::cast<AST::Statement, AST::ForStatement>(statement);
+
+      this->addScope();
+
+      this->foldStatement(loop->getInitializer());
+      this->declareNestedStatementName(loop->getBody());
+      loop->setCondition(this->foldExpression(loop->getCondition()));
+      loop->setIncrement(this->foldExpression(loop->getIncrement()));
+      this->foldNestedStatement(loop->getBody());
+
+      this->removeScope();
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::FunctionDeclarationStatement>(statement)) {
+      AST::FunctionDeclarationStatement* declaration = Shared::Classes::cast<AST::Statement, AST::FunctionDeclarationStatement>(statement);
+
+      // function is visible in its own body
+      this->declareName(declaration->getName().getCode(), NULL);
+      this->foldFunction(declaration->getParams(), declaration->getBody());
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ReturnStatement>(statement)) {
+      AST::ReturnStatement* returnStatement = Shared::Classes::cast<AST::Statement, AST::ReturnStatement>(statement);
+      returnStatement->setReturns(this->foldExpression(returnStatement->getReturns()));
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ImportStatement>(statement)) {
+      AST::ImportStatement* importStatement = Shared::Classes::cast<AST::Statement, AST::ImportStatement>(statement);
+      std::vector<Lexer::Token> imports = importStatement->getImports();
+
+      for (int i = 0; i < imports.size(); i++) {
+        // names imported with "*" are not known before execution
+        if (imports[i].isOfType(Specification::TokenType::MULTIPLICATION_TOKEN)) {
+          for (auto& [name, constant]: this->scopes.back()) constant = NULL;
+          continue;
+        }
+
+        this->declareName(imports[i].getCode(), NULL);
+      }
+      return;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ExportStatement>(statement)) {
+      return this->foldStatement(Shared::Classes::cast<AST::Statement, AST::ExportStatement>(statement)->getExports());
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ClassDeclarationStatement>(statement)) {
+      return this->foldClassDeclarationStatement(Shared::Classes::cast<AST::Statement, AST::ClassDeclarationStatement>(statement));
+    }
+
+    // break, continue and null statements have nothing to fold
+  }
+  void ConstantFolder::foldBlockStatement(AST::BlockStatement* statement) {
+    this->addScope();
+
+    for (int i = 0; i < statement->getStatements().size(); i++) {
+      this->foldStatement(statement->getStatements()[i]);
+    }
+
+    this->removeScope();
+  }
+  void ConstantFolder::foldNestedStatement(AST::Statement* statement) {
+    if (statement == NULL) return;
+
+    this->addScope();
+    this->foldStatement(statement);
+    this->removeScope();
+
+    this->declareNestedStatementName(statement);
+  }
+  void ConstantFolder::declareNestedStatementName(AST::Statement* statement) {
+    // unwrap exported declarations
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ExportStatement>(statement)) {
+      statement = Shared::Classes::cast<AST::Statement, AST::ExportStatement>(statement)->getExports();
+    }
+
+    // declaration may not be executed, so the name is never constant
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::VariableDeclarationStatement>(statement)) {
+      this->declareName(Shared::Classes::cast<AST::Statement, AST::VariableDeclarationStatement>(statement)->getName().getCode(), NULL);
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ConstantDeclarationStatement>(statement)) {
+      this->declareName(Shared::Classes::cast<AST::Statement, AST::ConstantDeclarationStatement>(statement)->getName().getCode(), NULL);
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::FunctionDeclarationStatement>(statement)) {
+      this->declareName(Shared::Classes::cast<AST::Statement, AST::FunctionDeclarationStatement>(statement)->getName().getCode(), NULL);
+    }
+    if (Shared::Classes::isInstanceOf<AST::Statement, AST::ClassDeclarationStatement>(statement)) {
+      this->declareName(Shared::Classes::cast<AST::Statement, AST::ClassDeclarationStatement>(statement)->getName().getCode(), NULL);
+    }
+  }
+  void ConstantFolder::foldFunction(const std::vector<AST::FunctionParameterExpression*>& params, AST::BlockStatement* body) {
+    // defaults are evaluated in calling stack, so no names are known there and only literal subtrees are folded
+    std::vector<std::unordered_map<std::string, AST::LiteralExpression*>> declarationScopes = { {} };
+    std::swap(this->scopes, declarationScopes);
+    for (int i = 0; i < params.size(); i++) {
+      params[i]->setDefaultValue(this->foldExpression(params[i]->getDefaultValue()));
+    }
+    std::swap(this->scopes, declarationScopes);
+
+    this->addScope();
+
+    // parameters shadow outer names
+    for (int i = 0; i < params.size(); i++) {
+      this->declareName(params[i]->getName().getCode(), NULL);
+    }
+
+    this->foldStatement(body);
+
+    this->removeScope();
+  }
+  void ConstantFolder::foldClassDeclarationStatement(AST::ClassDeclarationStatement* statement) {
+    this->declareName(statement->getName().getCode(), NULL);
+
+    this->addScope();
+
+    // members shadow outer names inside class body
+    for (int i = 0; i < statement->getDeclarations().size(); i++) {
+      this->declareName(statement->getDeclarations()[i]->getName().getCode(), NULL);
+    }
+
+    for (int i = 0; i < statement->getDeclarations().size(); i++) {
+      AST::ClassMemberDeclarationStatement* declaration = statement->getDeclarations()[i];
+
+      if (Shared::Classes::isInstanceOf<AST::ClassMemberDeclarationStatement, AST::ClassFieldDeclarationStatement>(declaration)) {
+        AST::ClassFieldDeclarationStatement* field = Shared::Classes::cast<AST::ClassMemberDeclarationStatement, AST::ClassFieldDeclarationStatement>(declaration);
+        field->setInitialization(this->foldExpression(field->getInitialization()));
+      }
+      if (Shared::Classes::isInstanceOf<AST::ClassMemberDeclarationStatement, AST::ClassMethodDeclarationStatement>(declaration)) {
+        AST::ClassMethodDeclarationStatement* method = Shared::Classes::cast<AST::ClassMemberDeclarationStatement, AST::ClassMethodDeclarationStatement>(declaration);
+        this->foldFunction(method->getParams(), method->getBody());
+      }
+    }
+
+    this->removeScope();
+  }
+
+  // expressions
+  AST::Expression* ConstantFolder::foldExpression(AST::Expression* expression) {
+    if (expression == NULL) return NULL;
+
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::IdentifierExpression>(expression)) {
+      AST::IdentifierExpression* identifier = Shared::Classes::cast<AST::Expression, AST::IdentifierExpression>(expression);
+      AST::LiteralExpression* constant = this->getConstantByName(identifier->getName().getCode());
+      if (constant == NULL) return expression;
+
+      AST::LiteralExpression* replacement = new AST::LiteralExpression(identifier->getPosition(), constant->getValue());
+      delete expression;
+      return replacement;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::UnaryOperationExpression>(expression)) {
+      return this->foldUnaryExpression(Shared::Classes::cast<AST::Expression, AST::UnaryOperationExpression>(expression));
+    }
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::BinaryOperationExpression>(expression)) {
+      return this->foldBinaryExpression(Shared::Classes::cast<AST::Expression, AST::BinaryOperationExpression>(expression));
+    }
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::GroupingExpression>(expression)) {
+      return this->foldGroupingExpression(Shared::Classes::cast<AST::Expression, AST::GroupingExpression>(expression));
+    }
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::GroupingApplicationExpression>(expression)) {
+      AST::GroupingApplicationExpression* application = Shared::Classes::cast<AST::Expression, AST::GroupingApplicationExpression>(expression);
+      application->setLeft(this->foldExpression(application->getLeft()));
+
+      // arguments and indexes are folded, but the grouping itself is kept
+      AST::GroupingExpression* arguments = application->getRight();
+      for (int i = 0; i < arguments->getExpressions().size(); i++) {
+        arguments->setExpression(i, this->foldExpression(arguments->getExpressions()[i]));
+      }
+
+      return expression;
+    }
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::AssociationExpression>(expression)) {
+      AST::AssociationExpression* association = Shared::Classes::cast<AST::Expression, AST::AssociationExpression>(expression);
+
+      // keys are names, so only values are folded
+      for (int i = 0; i < association->getEntries().size(); i++) {
+        association->setEntryValue(i, this->foldExpression(association->getEntries()[i].second));
+      }
+
+      return expression;
+    }
+
+    // literals and null expressions are already folded
+    return expression;
+  }
+  AST::Expression* ConstantFolder::foldAssignedExpression(AST::Expression* expression) {
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::IdentifierExpression>(expression)) return expression;
+    return this->foldExpression(expression);
+  }
+  AST::Expression* ConstantFolder::foldUnaryExpression(AST::UnaryOperationExpression* expression) {
+    if (expression->getOperator().isOfType({ Specification::TokenType::INCREMENT_TOKEN, Specification::TokenType::DECREMENT_TOKEN })) {
+      expression->setOperand(this->foldAssignedExpression(expression->getOperand()));
+      return expression;
+    }
+
+    expression->setOperand(this->foldExpression(expression->getOperand()));
+
+    if (!Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(expression->getOperand())) return expression;
+
+    AST::LiteralExpression* operand = Shared::Classes::cast<AST::Expression, AST::LiteralExpression>(expression->getOperand());
+    std::optional<Lexer::Token> result = this->computeUnaryOperation(expression->getOperator(), operand);
+    if (!result.has_value()) return expression;
+
+    AST::LiteralExpression* replacement = new AST::LiteralExpression(expression->getPosition(), result.value());
+    delete expression;
+    return replacement;
+  }
+  AST::Expression* ConstantFolder::foldBinaryExpression(AST::BinaryOperationExpression* expression) {
+    Lexer::Token operatorToken = expression->getOperator();
+
+    // lambda parameters are names
+    if (operatorToken.isOfType(Specification::TokenType::LAMBDA_TOKEN)) return expression;
+
+    // member name on the right side is not evaluated
+    if (operatorToken.isOfType(Specification::TokenType::DOT_TOKEN)) {
+      expression->setLeft(this->foldExpression(expression->getLeft()));
+      return expression;
+    }
+
+    std::vector<Specification::TokenType> assignOperators = {
+      Specification::TokenType::ASSIGN_TOKEN,
+      Specification::TokenType::PLUS_ASSIGN_TOKEN,
+      Specification::TokenType::MINUS_ASSIGN_TOKEN,
+      Specification::TokenType::MULTIPLICATION_ASSIGN_TOKEN,
+      Specification::TokenType::DIVISION_ASSIGN_TOKEN,
+      Specification::TokenType::REMAINDER_ASSIGN_TOKEN,
+      Specification::TokenType::EXPONENTIAL_ASSIGN_TOKEN,
+      Specification::TokenType::BIT_AND_ASSIGN_TOKEN,
+      Specification::TokenType::BIT_OR_ASSIGN_TOKEN,
+      Specification::TokenType::BIT_XOR_ASSIGN_TOKEN,
+      Specification::TokenType::LEFT_SHIFT_ASSIGN_TOKEN,
+      Specification::TokenType::RIGHT_SHIFT_ASSIGN_TOKEN,
+    };
+
+    if (operatorToken.isOfType(assignOperators)) {
+      expression->setLeft(this->foldAssignedExpression(expression->getLeft()));
+      expression->setRight(this->foldExpression(expression->getRight()));
+      return expression;
+    }
+
+    expression->setLeft(this->foldExpression(expression->getLeft()));
+    expression->setRight(this->foldExpression(expression->getRight()));
+
+    // logical operators return one of operands, so only the left one has to be known
+    if (operatorToken.isOfType({ Specification::TokenType::AND_TOKEN, Specification::TokenType::OR_TOKEN })) {
+      if (!Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(expression->getLeft())) return expression;
+
+      bool condition = this->getLiteralBoolean(Shared::Classes::cast<AST::Expression, AST::LiteralExpression>(expression->getLeft()));
+      bool isLeftReturned = operatorToken.isOfType(Specification::TokenType::AND_TOKEN) ? !condition : condition;
+
+      AST::Expression* replacement = isLeftReturned ? expression->getLeft() : expression->getRight();
+
+      // detach the returned operand before freeing the operation
+      if (isLeftReturned) expression->setLeft(NULL);
+      else expression->setRight(NULL);
+
+      delete expression;
+      return replacement;
+    }
+
+    bool isLeftLiteral = Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(expression->getLeft());
+    bool isRightLiteral = Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(expression->getRight());
+
+    if (isLeftLiteral && isRightLiteral) {
+      AST::LiteralExpression* left = Shared::Classes::cast<AST::Expression, AST::LiteralExpression>(expression->getLeft());
+      AST::LiteralExpression* right = Shared::Classes::cast<AST::Expression, AST::LiteralExpression>(expression->getRight());
+
+      std::optional<Lexer::Token> result = this->computeBinaryOperation(operatorToken, left, right);
+      if (!result.has_value()) return expression;
+
+      AST::LiteralExpression* replacement = new AST::LiteralExpression(expression->getPosition(), result.value());
+      delete expression;
+      return replacement;
+    }
+
+    AST::Expression* identityOperand = this->getIdentityOperand(expression);
+    if (identityOperand == NULL) return expression;
+
+    if (identityOperand == expression->getLeft()) expression->setLeft(NULL);
+    else expression->setRight(NULL);
+
+    delete expression;
+    return identityOperand;
+  }
+  AST::Expression* ConstantFolder::foldGroupingExpression(AST::GroupingExpression* expression) {
+    for (int i = 0; i < expression->getExpressions().size(); i++) {
+      expression->setExpression(i, this->foldExpression(expression->getExpressions()[i]));
+    }
+
+    // only parentheses are unwrapped, square brackets create vectors
+    if (!expression->getOperator().isOfType(Specification::TokenType::LEFT_PARENTHESES_TOKEN)) return expression;
+    if (!expression->getExpressions().size()) return expression;
+
+    // parentheses of literals evaluate to the last literal
+    for (int i = 0; i < expression->getExpressions().size(); i++) {
+      if (!Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(expression->getExpressions()[i])) return expression;
+    }
+
+    int lastIndex = expression->getExpressions().size() - 1;
+    AST::Expression* replacement = expression->getExpressions()[lastIndex];
+    expression->setExpression(lastIndex, NULL);
+
+    delete expression;
+    return replacement;
+  }
+
+  std::optional<Lexer::Token> ConstantFolder::computeUnaryOperation(Lexer::Token operatorToken, AST::LiteralExpression* operand) {
+    Base::Position position = operatorToken.getPosition();
+
+    if (operatorToken.isOfType(Specification::TokenType::NOT_TOKEN)) {
+      return this->createBooleanToken(position, !this->getLiteralBoolean(operand));
+    }
+    if (operatorToken.isOfType(Specification::TokenType::BIT_NOT_TOKEN)) {
+      std::optional<double> value = this->getLiteralNumber(operand);
+      if (!value.has_value() || !this->isIntegerCastable(value.value())) return std::nullopt;
+
+      long long operandValue = value.value();
+      return this->createNumberToken(position, ~operandValue);
+    }
+
+    return std::nullopt;
+  }
+  std::optional<Lexer::Token> ConstantFolder::computeBinaryOperation(Lexer::Token operatorToken, AST::LiteralExpression* left, AST::LiteralExpression* right) {
+    Base::Position position = operatorToken.getPosition();
+
+    // equality is defined for every pair of values
+    if (operatorToken.isOfType(Specification::TokenType::EQUAL_TOKEN)) {
+      return this->createBooleanToken(position, this->compareLiterals(left, right));
+    }
+    if (operatorToken.isOfType(Specification::TokenType::NOT_EQUAL_TOKEN)) {
+      return this->createBooleanToken(position, !this->compareLiterals(left, right));
+    }
+
+    // string + string
+    if (operatorToken.isOfType(Specification::TokenType::PLUS_TOKEN)) {
+      if (this->isLiteralOfType(left, Specification::TokenType::STRING_TOKEN) && this->isLiteralOfType(right, Specification::TokenType::STRING_TOKEN)) {
+        return Lexer::Token(position, Specification::TokenType::STRING_TOKEN, left->getValue().getCode() + right->getValue().getCode());
+      }
+    }
+
+    // other operators are defined for numbers only
+    std::optional<double> leftNumber = this->getLiteralNumber(left);
+    std::optional<double> rightNumber = this->getLiteralNumber(right);
+    if (!leftNumber.has_value() || !rightNumber.has_value()) return std::nullopt;
+
+    double leftValue = leftNumber.value();
+    double rightValue = rightNumber.value();
+
+    if (operatorToken.isOfType(Specification::TokenType::PLUS_TOKEN)) {
+      return this->createNumberToken(position, leftValue + rightValue);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::MINUS_TOKEN)) {
+      return this->createNumberToken(position, leftValue - rightValue);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::MULTIPLICATION_TOKEN)) {
+      return this->createNumberToken(position, leftValue * rightValue);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::DIVISION_TOKEN)) {
+      return this->createNumberToken(position, leftValue / rightValue);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::EXPONENTIAL_TOKEN)) {
+      return this->createNumberToken(position, std::pow(leftValue, rightValue));
+    }
+
+    if (operatorToken.isOfType(Specification::TokenType::GREATER_THAN_TOKEN)) {
+      return this->createBooleanToken(position, leftValue > rightValue);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::LESS_THAN_TOKEN)) {
+      return this->createBooleanToken(position, leftValue < rightValue);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::GREATER_THAN_OR_EQUAL_TOKEN)) {
+      return this->createBooleanToken(position, leftValue >= rightValue);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::LESS_THAN_OR_EQUAL_TOKEN)) {
+      return this->createBooleanToken(position, leftValue <= rightValue);
+    }
+
+    // integer operators cast operands to long long like executor
+    // operations with undefined behavior are left to runtime
+    if (!this->isIntegerCastable(leftValue) || !this->isIntegerCastable(rightValue)) return std::nullopt;
+
+    long long leftInteger = leftValue;
+    long long rightInteger = rightValue;
+
+    if (operatorToken.isOfType(Specification::TokenType::REMAINDER_TOKEN)) {
+      if (rightInteger == 0 || rightInteger == -1) return std::nullopt;
+      return this->createNumberToken(position, leftInteger % rightInteger);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::BIT_AND_TOKEN)) {
+      return this->createNumberToken(position, leftInteger & rightInteger);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::BIT_OR_TOKEN)) {
+      return this->createNumberToken(position, leftInteger | rightInteger);
+    }
+    if (operatorToken.isOfType(Specification::TokenType::BIT_XOR_TOKEN)) {
+      return this->createNumberToken(position, leftInteger ^ rightInteger);
+    }
+    if (operatorToken.isOfType({ Specification::TokenType::LEFT_SHIFT_TOKEN, Specification::TokenType::RIGHT_SHIFT_TOKEN })) {
+      if (rightInteger < 0 || rightInteger >= 64) return std::nullopt;
+
+      if (operatorToken.isOfType(Specification::TokenType::LEFT_SHIFT_TOKEN)) {
+        return this->createNumberToken(position, leftInteger << rightInteger);
+      }
+      return this->createNumberToken(position, leftInteger >> rightInteger);
+    }
+
+    return std::nullopt;
+  }
+  AST::Expression* ConstantFolder::getIdentityOperand(AST::BinaryOperationExpression* expression) {
+    Lexer::Token operatorToken = expression->getOperator();
+
+    std::optional<double> leftNumber = this->getLiteralNumber(expression->getLeft());
+    std::optional<double> rightNumber = this->getLiteralNumber(expression->getRight());
+
+    // identities are exact for every number (including NaN and -0), other types throw
+    if (this->isNumericExpression(expression->getLeft()) && rightNumber.has_value()) {
+      if (operatorToken.isOfType(Specification::TokenType::MULTIPLICATION_TOKEN) && rightNumber.value() == 1) return expression->getLeft();
+      if (operatorToken.isOfType(Specification::TokenType::DIVISION_TOKEN) && rightNumber.value() == 1) return expression->getLeft();
+      if (operatorToken.isOfType(Specification::TokenType::EXPONENTIAL_TOKEN) && rightNumber.value() == 1) return expression->getLeft();
+      if (operatorToken.isOfType(Specification::TokenType::MINUS_TOKEN) && rightNumber.value() == 0 && !std::signbit(rightNumber.value())) return expression->getLeft();
+    }
+    if (this->isNumericExpression(expression->getRight()) && leftNumber.has_value()) {
+      if (operatorToken.isOfType(Specification::TokenType::MULTIPLICATION_TOKEN) && leftNumber.value() == 1) return expression->getRight();
+    }
+
+    return NULL;
+  }
+
+  bool ConstantFolder::isLiteralOfType(AST::Expression* expression, Specification::TokenType type) {
+    if (!Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(expression)) return false;
+    return Shared::Classes::cast<AST::Expression, AST::LiteralExpression>(expression)->getValue().isOfType(type);
+  }
+  std::optional<double> ConstantFolder::getLiteralNumber(AST::Expression* expression) {
+    if (!this->isLiteralOfType(expression, Specification::TokenType::NUMBER_TOKEN)) return std::nullopt;
+
+    // invalid numbers are reported by executor
+    try {
+      return std::stod(Shared::Classes::cast<AST::Expression, AST::LiteralExpression>(expression)->getValue().getCode());
+    }
+    catch (const std::exception&) {
+      return std::nullopt;
+    }
+  }
+  bool ConstantFolder::getLiteralBoolean(AST::LiteralExpression* literal) {
+    Lexer::Token value = literal->getValue();
+
+    if (value.isOfType(Specification::TokenType::TRUE_KEYWORD_TOKEN)) return true;
+    if (value.isOfType(Specification::TokenType::STRING_TOKEN)) return value.getCode().size() != 0;
+    if (value.isOfType(Specification::TokenType::NUMBER_TOKEN)) {
+      std::optional<double> number = this->getLiteralNumber(literal);
+      return !number.has_value() || number.value() != 0;
+    }
+
+    // null and false
+    return false;
+  }
+  bool ConstantFolder::compareLiterals(AST::LiteralExpression* left, AST::LiteralExpression* right) {
+    Lexer::Token leftValue = left->getValue();
+    Lexer::Token rightValue = right->getValue();
+
+    // numbers are compared by value (NaN is not equal to itself)
+    if (leftValue.isOfType(Specification::TokenType::NUMBER_TOKEN) || rightValue.isOfType(Specification::TokenType::NUMBER_TOKEN)) {
+      std::optional<double> leftNumber = this->getLiteralNumber(left);
+      std::optional<double> rightNumber = this->getLiteralNumber(right);
+      return leftNumber.has_value() && rightNumber.has_value() && leftNumber.value() == rightNumber.value();
+    }
+
+    if (leftValue.getType() != rightValue.getType()) return false;
+    if (leftValue.isOfType(Specification::TokenType::STRING_TOKEN)) return leftValue.getCode() == rightValue.getCode();
+
+    // the same keyword (null, true, false)
+    return true;
+  }
+  bool ConstantFolder::isNumericExpression(AST::Expression* expression) {
+    if (this->isLiteralOfType(expression, Specification::TokenType::NUMBER_TOKEN)) return true;
+
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::UnaryOperationExpression>(expression)) {
+      AST::UnaryOperationExpression* unary = Shared::Classes::cast<AST::Expression, AST::UnaryOperationExpression>(expression);
+      return unary->getOperator().isOfType(Specification::TokenType::BIT_NOT_TOKEN);
+    }
+
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::BinaryOperationExpression>(expression)) {
+      AST::BinaryOperationExpression* binary = Shared::Classes::cast<AST::Expression, AST::BinaryOperationExpression>(expression);
+
+      // addition of strings is not numeric
+      if (binary->getOperator().isOfType(Specification::TokenType::PLUS_TOKEN)) {
+        return this->isNumericExpression(binary->getLeft()) && this->isNumericExpression(binary->getRight());
+      }
+
+      return binary->getOperator().isOfType({
+        Specification::TokenType::MINUS_TOKEN,
+        Specification::TokenType::MULTIPLICATION_TOKEN,
+        Specification::TokenType::DIVISION_TOKEN,
+        Specification::TokenType::EXPONENTIAL_TOKEN,
+        Specification::TokenType::REMAINDER_TOKEN,
+        Specification::TokenType::BIT_AND_TOKEN,
+        Specification::TokenType::BIT_OR_TOKEN,
+        Specification::TokenType::BIT_XOR_TOKEN,
+        Specification::TokenType::LEFT_SHIFT_TOKEN,
+        Specification::TokenType::RIGHT_SHIFT_TOKEN,
+      });
+    }
+
+    return false;
+  }
+  bool ConstantFolder::isIntegerCastable(double value) {
+    // NaN fails both comparisons
+    return value >= -9223372036854775808.0 && value < 9223372036854775808.0;
+  }
+
+  Lexer::Token ConstantFolder::createNumberToken(Base::Position position, double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.*g", FOLDED_NUMBER_PRECISION, value);
+    return Lexer::Token(position, Specification::TokenType::NUMBER_TOKEN, buffer);
+  }
+  Lexer::Token ConstantFolder::createBooleanToken(Base::Position position, bool value) {
+    if (value) return Lexer::Token(position, Specification::TokenType::TRUE_KEYWORD_TOKEN, Specification::TRUE_KEYWORD);
+    return Lexer::Token(position, Specification::TokenType::FALSE_KEYWORD_TOKEN, Specification::FALSE_KEYWORD);
+  }
+}
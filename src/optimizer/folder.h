@@ -0,0 +1,72 @@
+#pragma once
+
+#include <unordered_map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "parser/ast.h"
+
+// this module contains constant folding pass
+// it runs between parsing and execution and rewrites AST in place
+// folded values follow executor semantics, so the pass never changes program output
+namespace Optimizer {
+  // pass can be disabled to debug executor on the original tree
+  inline const bool IS_CONSTANT_FOLDING_ENABLED_BY_DEFAULT = true;
+
+  // numbers are printed with enough digits to be parsed back exactly
+  inline const int FOLDED_NUMBER_PRECISION = 17;
+
+  class ConstantFolder {
+    private:
+      // scopes of known constants from outer to inner
+      // NULL marks a name that is declared in scope but is not a literal constant
+      std::vector<std::unordered_map<std::string, AST::LiteralExpression*>> scopes;
+
+      void addScope();
+      void removeScope();
+      void declareName(std::string, AST::LiteralExpression*);
+      AST::LiteralExpression* getConstantByName(std::string);
+
+      // statements
+      void foldStatement(AST::Statement*);
+      void foldBlockStatement(AST::BlockStatement*);
+      // branches and loop bodies that are not blocks declare names in enclosing scope
+      void foldNestedStatement(AST::Statement*);
+      void declareNestedStatementName(AST::Statement*);
+      void foldFunction(const std::vector<AST::FunctionParameterExpression*>&, AST::BlockStatement*);
+      void foldClassDeclarationStatement(AST::ClassDeclarationStatement*);
+
+      // expressions return the node that replaces the given one (replaced nodes are freed)
+      AST::Expression* foldExpression(AST::Expression*);
+      // assigned identifiers are kept, so assignment errors are reported by executor
+      AST::Expression* foldAssignedExpression(AST::Expression*);
+      AST::Expression* foldUnaryExpression(AST::UnaryOperationExpression*);
+      AST::Expression* foldBinaryExpression(AST::BinaryOperationExpression*);
+      AST::Expression* foldGroupingExpression(AST::GroupingExpression*);
+
+      // computations over literals (empty if operation is not folded)
+      std::optional<Lexer::Token> computeUnaryOperation(Lexer::Token, AST::LiteralExpression*);
+      std::optional<Lexer::Token> computeBinaryOperation(Lexer::Token, AST::LiteralExpression*, AST::LiteralExpression*);
+      // returns the operand that the whole expression is equal to (NULL if no identity matches)
+      AST::Expression* getIdentityOperand(AST::BinaryOperationExpression*);
+
+      // literal utils
+      bool isLiteralOfType(AST::Expression*, Specification::TokenType);
+      std::optional<double> getLiteralNumber(AST::Expression*);
+      bool getLiteralBoolean(AST::LiteralExpression*);
+      bool compareLiterals(AST::LiteralExpression*, AST::LiteralExpression*);
+      // expressions that either evaluate to number or throw
+      bool isNumericExpression(AST::Expression*);
+      // checks that number can be cast to long long like executor does
+      bool isIntegerCastable(double);
+
+      Lexer::Token createNumberToken(Base::Position, double);
+      Lexer::Token createBooleanToken(Base::Position, bool);
+
+    public:
+      ConstantFolder();
+
+      void fold(AST::BlockStatement*);
+  };
+}
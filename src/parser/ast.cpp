@@ -27,6 +27,9 @@ namespace AST {
   Expression* UnaryOperationExpression::getOperand() const {
     return this->operand;
   }
+  void UnaryOperationExpression::setOperand(Expression* operand) {
+    this->operand = operand;
+  }
 
   PrefixUnaryOperationExpression::PrefixUnaryOperationExpression(Base::Position position, Lexer::Token operatorToken, Expression* operand): UnaryOperationExpression(position, operatorToken, operand) {}
   PrefixUnaryOperationExpression* PrefixUnaryOperationExpression::clone() const {
@@ -48,6 +51,8 @@ namespace AST {
     this->operatorToken = operatorToken;
     this->left = left;
     this->right = right;
+    this->kernelOperator = Runtime::getKernelOperator(operatorToken.getType());
+    this->assignKernelOperator = Runtime::getAssignKernelOperator(operatorToken.getType());
   }
   BinaryOperationExpression::~BinaryOperationExpression() {
     delete this->left;
@@ -65,16 +70,46 @@ namespace AST {
   Expression* BinaryOperationExpression::getRight() const {
     return this->right;
   }
+  void BinaryOperationExpression::setLeft(Expression* left) {
+    this->left = left;
+  }
+  void BinaryOperationExpression::setRight(Expression* right) {
+    this->right = right;
+  }
+  Runtime::KernelOperator BinaryOperationExpression::getKernelOperator() const {
+    return this->kernelOperator;
+  }
+  Runtime::KernelOperator BinaryOperationExpression::getAssignKernelOperator() const {
+    return this->assignKernelOperator;
+  }
+  Runtime::OperationProfile* BinaryOperationExpression::getProfile() {
+    return &this->profile;
+  }
+  Runtime::MemberCache* BinaryOperationExpression::getMemberCache() {
+    return &this->memberCache;
+  }
 
   LiteralExpression::LiteralExpression(Base::Position position, Lexer::Token value): value(value) {
     this->value = value;
+    this->isMaterialized = false;
   }
   LiteralExpression* LiteralExpression::clone() const {
+    // clone is materialized by the runtime that evaluates it
     return new LiteralExpression(this->position, this->getValue());
   }
   Lexer::Token LiteralExpression::getValue() const {
     return this->value;
   }
+  bool LiteralExpression::getIsMaterialized() const {
+    return this->isMaterialized;
+  }
+  Runtime::TaggedValue LiteralExpression::getRuntimeValue() const {
+    return this->runtimeValue;
+  }
+  void LiteralExpression::setRuntimeValue(Runtime::TaggedValue runtimeValue) {
+    this->runtimeValue = runtimeValue;
+    this->isMaterialized = true;
+  }
 
   IdentifierExpression::IdentifierExpression(Base::Position position, Lexer::Token name): name(name) {
     this->name = name;
@@ -108,9 +143,12 @@ namespace AST {
   Lexer::Token GroupingExpression::getOperator() const {
     return this->operatorToken;
   }
-  std::vector<Expression*> GroupingExpression::getExpressions() const {
+  const std::vector<Expression*>& GroupingExpression::getExpressions() const {
     return this->expressions;
   }
+  void GroupingExpression::setExpression(int index, Expression* expression) {
+    this->expressions[index] = expression;
+  }
 
   GroupingApplicationExpression::GroupingApplicationExpression(Base::Position position, Expression* left, GroupingExpression* right) {
     this->position = position;
@@ -130,6 +168,9 @@ namespace AST {
   GroupingExpression* GroupingApplicationExpression::getRight() const {
     return this->right;
   }
+  void GroupingApplicationExpression::setLeft(Expression* left) {
+    this->left = left;
+  }
 
   AssociationExpression::AssociationExpression(Base::Position position, std::vector<std::pair<Expression*, Expression*>> entries) {
     this->position = position;
@@ -153,9 +194,15 @@ namespace AST {
 
     return new AssociationExpression(this->position, entries);
   }
-  std::vector<std::pair<Expression*, Expression*>> AssociationExpression::getEntries() const {
+  const std::vector<std::pair<Expression*, Expression*>>& AssociationExpression::getEntries() const {
     return this->entries;
   }
+  void AssociationExpression::setEntryValue(int index, Expression* value) {
+    this->entries[index].second = value;
+  }
+  Runtime::LiteralShapeCache* AssociationExpression::getShapeCache() {
+    return &this->shapeCache;
+  }
 
   FunctionParameterExpression::FunctionParameterExpression(Base::Position position, Lexer::Token name, Expression* defaultValue): name(name) {
     this->name = name;
@@ -173,6 +220,9 @@ namespace AST {
   Expression* FunctionParameterExpression::getDefaultValue() const {
     return this->defaultValue;
   }
+  void FunctionParameterExpression::setDefaultValue(Expression* defaultValue) {
+    this->defaultValue = defaultValue;
+  }
 
   // statement variants
   NullStatement::NullStatement(Base::Position position) {
@@ -195,6 +245,9 @@ namespace AST {
   Expression* ExpressionStatement::getExpression() const {
     return this->expression;
   }
+  void ExpressionStatement::setExpression(Expression* expression) {
+    this->expression = expression;
+  }
 
   BlockStatement::BlockStatement(Base::Position position, std::vector<Statement*> statements) {
     this->position = position;
@@ -214,7 +267,7 @@ namespace AST {
 
     return new BlockStatement(this->position, statements);
   }
-  std::vector<Statement*> BlockStatement::getStatements() const {
+  const std::vector<Statement*>& BlockStatement::getStatements() const {
     return this->statements;
   }
 
@@ -235,6 +288,9 @@ namespace AST {
   Expression* VariableDeclarationStatement::getInitializer() const {
     return this->initializer;
   }
+  void VariableDeclarationStatement::setInitializer(Expression* initializer) {
+    this->initializer = initializer;
+  }
 
   ConstantDeclarationStatement::ConstantDeclarationStatement(Base::Position position, Lexer::Token name, Expression* initializer): name(name) {
     this->position = position;
@@ -253,6 +309,9 @@ namespace AST {
   Expression* ConstantDeclarationStatement::getInitializer() const {
     return this->initializer;
   }
+  void ConstantDeclarationStatement::setInitializer(Expression* initializer) {
+    this->initializer = initializer;
+  }
 
   ConditionStatement::ConditionStatement(Base::Position position, Expression* condition, Statement* thenBranch, Statement* elseBranch) {
     this->position = position;
@@ -277,6 +336,9 @@ namespace AST {
   Statement* ConditionStatement::getElseBranch() const {
     return this->elseBranch;
   }
+  void ConditionStatement::setCondition(Expression* condition) {
+    this->condition = condition;
+  }
 
   WhileStatement::WhileStatement(Base::Position position, Expression* condition, Statement* body) {
     this->position = position;
@@ -296,6 +358,9 @@ namespace AST {
   Statement* WhileStatement::getBody() const {
     return this->body;
   }
+  void WhileStatement::setCondition(Expression* condition) {
+    this->condition = condition;
+  }
 
   ForStatement::ForStatement(Base::Position position, Statement* initializer, Expression* condition, Expression* increment, Statement* body) {
     this->position = position;
@@ -331,6 +396,12 @@ namespace AST {
   Statement* ForStatement::getBody() const {
     return this->body;
   }
+  void ForStatement::setCondition(Expression* condition) {
+    this->condition = condition;
+  }
+  void ForStatement::setIncrement(Expression* increment) {
+    this->increment = increment;
+  }
 
   BreakStatement::BreakStatement(Base::Position position) {
     this->position = position;
@@ -369,7 +440,7 @@ namespace AST {
   Lexer::Token FunctionDeclarationStatement::getName() const {
     return this->name;
   }
-  std::vector<FunctionParameterExpression*> FunctionDeclarationStatement::getParams() const {
+  const std::vector<FunctionParameterExpression*>& FunctionDeclarationStatement::getParams() const {
     return this->params;
   }
   BlockStatement* FunctionDeclarationStatement::getBody() const {
@@ -389,6 +460,9 @@ namespace AST {
   Expression* ReturnStatement::getReturns() const {
     return this->returns;
   }
+  void ReturnStatement::setReturns(Expression* returns) {
+    this->returns = returns;
+  }
 
   ImportStatement::ImportStatement(Base::Position position, Lexer::Token path, std::vector<Lexer::Token> imports): path(path) {
     this->position = position;
@@ -454,8 +528,11 @@ namespace AST {
   Expression* ClassFieldDeclarationStatement::getInitialization() const {
     return this->initialization;
   }
+  void ClassFieldDeclarationStatement::setInitialization(Expression* initialization) {
+    this->initialization = initialization;
+  }
 
-  ClassMethodDeclarationStatement::ClassMethodDeclarationStatement(Base::Position position, Specification::TokenType accessModifier, bool isStatic, Lexer::Token name, std::vector<FunctionParameterExpression*> params, BlockStatement* body): ClassMemberDeclarationStatement(position, accessModifier, isStatic, isConstant, name) {
+  ClassMethodDeclarationStatement::ClassMethodDeclarationStatement(Base::Position position, Specification::TokenType accessModifier, bool isStatic, Lexer::Token name, std::vector<FunctionParameterExpression*> params, BlockStatement* body): ClassMemberDeclarationStatement(position, accessModifier, isStatic, true, name) {
     this->params = params;
     this->body = body;
   }
@@ -474,7 +551,7 @@ namespace AST {
 
     return new ClassMethodDeclarationStatement(this->position, this->accessModifier, this->isStatic, this->name, clonedParams, this->body->clone());
   }
-  std::vector<FunctionParameterExpression*> ClassMethodDeclarationStatement::getParams() const {
+  const std::vector<FunctionParameterExpression*>& ClassMethodDeclarationStatement::getParams() const {
     return this->params;
   }
   BlockStatement* ClassMethodDeclarationStatement::getBody() const {
@@ -511,10 +588,10 @@ namespace AST {
   Lexer::Token ClassDeclarationStatement::getName() const {
     return this->name;
   }
-  std::vector<Expression*> ClassDeclarationStatement::getExtensionExpressions() const {
+  const std::vector<Expression*>& ClassDeclarationStatement::getExtensionExpressions() const {
     return this->extensionExpressions;
   }
-  std::vector<ClassMemberDeclarationStatement*> ClassDeclarationStatement::getDeclarations() const {
+  const std::vector<ClassMemberDeclarationStatement*>& ClassDeclarationStatement::getDeclarations() const {
     return this->declarations;
   }
 }
@@ -5,11 +5,16 @@
 #include <string>
 
 #include "lexer/token.h"
+#include "runtime/caches.h"
+#include "runtime/operators.h"
+#include "runtime/quickening.h"
+#include "runtime/tagged.h"
 #include "specification/specification.h"
 
 // this module declares hierarchy of classes for AST tree
 // because the structure is tree, parent nodes are responsible for children memory
 // destructors free memory for their children
+// setters replace children without freeing them (used by optimization passes)
 namespace AST {
   class Node {
     protected:
@@ -51,6 +56,8 @@ namespace AST {
 
       Lexer::Token getOperator() const;
       Expression* getOperand() const;
+
+      void setOperand(Expression*);
   };
 
   class PrefixUnaryOperationExpression: public UnaryOperationExpression {
@@ -77,6 +84,15 @@ namespace AST {
       Expression* left;
       Expression* right;
 
+      // kernels of operator resolved once from operator token
+      Runtime::KernelOperator kernelOperator;
+      Runtime::KernelOperator assignKernelOperator;
+
+      // operand types seen by the runtime, used to quicken the operation
+      Runtime::OperationProfile profile;
+      // layouts resolved by member access, used by access operator only
+      Runtime::MemberCache memberCache;
+
     public:
       BinaryOperationExpression(Base::Position position, Lexer::Token operatorToken, Expression* left, Expression* right);
       ~BinaryOperationExpression();
@@ -86,18 +102,35 @@ namespace AST {
       Lexer::Token getOperator() const;
       Expression* getLeft() const;
       Expression* getRight() const;
+
+      void setLeft(Expression*);
+      void setRight(Expression*);
+
+      Runtime::KernelOperator getKernelOperator() const;
+      Runtime::KernelOperator getAssignKernelOperator() const;
+      Runtime::OperationProfile* getProfile();
+      Runtime::MemberCache* getMemberCache();
   };
 
   class LiteralExpression: public Expression {
     private:
       Lexer::Token value;
 
+      // runtime value is converted from token once and is reused by every evaluation
+      // it is immutable and permanent (numbers, booleans, null, interned strings)
+      Runtime::TaggedValue runtimeValue;
+      bool isMaterialized;
+
     public:
       LiteralExpression(Base::Position position, Lexer::Token value);
 
       LiteralExpression* clone() const;
 
       Lexer::Token getValue() const;
+
+      bool getIsMaterialized() const;
+      Runtime::TaggedValue getRuntimeValue() const;
+      void setRuntimeValue(Runtime::TaggedValue);
   };
 
   class IdentifierExpression: public Expression {
@@ -125,7 +158,9 @@ namespace AST {
       GroupingExpression* clone() const;
 
       Lexer::Token getOperator() const;
-      std::vector<Expression*> getExpressions() const;
+      const std::vector<Expression*>& getExpressions() const;
+
+      void setExpression(int, Expression*);
   };
 
   // used when expression is followed by grouping expression 
@@ -142,6 +177,8 @@ namespace AST {
 
       Expression* getLeft() const;
       GroupingExpression* getRight() const;
+
+      void setLeft(Expression*);
   };
 
   // for {} maps
@@ -149,13 +186,20 @@ namespace AST {
     private:
       std::vector<std::pair<Expression*, Expression*>> entries;
 
+      // layout of objects created by the literal
+      Runtime::LiteralShapeCache shapeCache;
+
     public:
       AssociationExpression(Base::Position position, std::vector<std::pair<Expression*, Expression*>> entries);
       ~AssociationExpression();
 
       AssociationExpression* clone() const;
 
-      std::vector<std::pair<Expression*, Expression*>> getEntries() const;
+      const std::vector<std::pair<Expression*, Expression*>>& getEntries() const;
+
+      void setEntryValue(int, Expression*);
+
+      Runtime::LiteralShapeCache* getShapeCache();
   };
 
   class FunctionParameterExpression: public Expression {
@@ -172,6 +216,8 @@ namespace AST {
 
       Lexer::Token getName() const;
       Expression* getDefaultValue() const;
+
+      void setDefaultValue(Expression*);
   };
 
   // statement variants
@@ -193,6 +239,8 @@ namespace AST {
       ExpressionStatement* clone() const;
 
       Expression* getExpression() const;
+
+      void setExpression(Expression*);
   };
 
   class BlockStatement: public Statement {
@@ -205,7 +253,7 @@ namespace AST {
 
       BlockStatement* clone() const;
 
-      std::vector<Statement*> getStatements() const;
+      const std::vector<Statement*>& getStatements() const;
   };
 
   class VariableDeclarationStatement: public Statement {
@@ -221,6 +269,8 @@ namespace AST {
 
       Lexer::Token getName() const;
       Expression* getInitializer() const;
+
+      void setInitializer(Expression*);
   };
 
   class ConstantDeclarationStatement: public Statement {
@@ -236,6 +286,8 @@ namespace AST {
 
       Lexer::Token getName() const;
       Expression* getInitializer() const;
+
+      void setInitializer(Expression*);
   };
 
   class ConditionStatement: public Statement {
@@ -253,6 +305,8 @@ namespace AST {
       Expression* getCondition() const;
       Statement* getThenBranch() const;
       Statement* getElseBranch() const;
+
+      void setCondition(Expression*);
   };
 
   class WhileStatement: public Statement {
@@ -268,6 +322,8 @@ namespace AST {
       
       Expression* getCondition() const;
       Statement* getBody() const;
+
+      void setCondition(Expression*);
   };
 
   class ForStatement: public Statement {
@@ -287,6 +343,9 @@ namespace AST {
       Expression* getCondition() const;
       Expression* getIncrement() const;
       Statement* getBody() const;
+
+      void setCondition(Expression*);
+      void setIncrement(Expression*);
   };
 
   class BreakStatement: public Statement {
@@ -315,7 +374,7 @@ namespace AST {
       FunctionDeclarationStatement* clone() const;
 
       Lexer::Token getName() const;
-      std::vector<FunctionParameterExpression*> getParams() const;
+      const std::vector<FunctionParameterExpression*>& getParams() const;
       BlockStatement* getBody() const;
   };
 
@@ -330,6 +389,8 @@ namespace AST {
       ReturnStatement* clone() const;
 
       Expression* getReturns() const;
+
+      void setReturns(Expression*);
   };
 
   class ImportStatement: public Statement {
@@ -388,6 +449,8 @@ namespace AST {
       ClassFieldDeclarationStatement* clone() const;
 
       Expression* getInitialization() const;
+
+      void setInitialization(Expression*);
   };
 
   class ClassMethodDeclarationStatement: public ClassMemberDeclarationStatement {
@@ -401,7 +464,7 @@ namespace AST {
 
       ClassMethodDeclarationStatement* clone() const;
 
-      std::vector<FunctionParameterExpression*> getParams() const;
+      const std::vector<FunctionParameterExpression*>& getParams() const;
       AST::BlockStatement* getBody() const;
   };
 
@@ -418,7 +481,7 @@ namespace AST {
       ClassDeclarationStatement* clone() const;
 
       Lexer::Token getName() const;
-      std::vector<Expression*> getExtensionExpressions() const;
-      std::vector<ClassMemberDeclarationStatement*> getDeclarations() const;
+      const std::vector<Expression*>& getExtensionExpressions() const;
+      const std::vector<ClassMemberDeclarationStatement*>& getDeclarations() const;
   };
 }
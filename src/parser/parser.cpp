@@ -692,6 +692,9 @@ namespace Parser {
 
       AST::ClassMemberDeclarationStatement* declaration = this->parseClassMemberDeclarationStatement();
       declarations.push_back(declaration);
+
+      // field initializers stop before newline, closing brace can follow them
+      this->skipMultilineSpaceTokens();
     }
 
     this->skipMultilineSpaceTokens();
@@ -726,11 +729,13 @@ namespace Parser {
 
       // get static modifier
       isStatic = this->matchToken(Specification::TokenType::STATIC_KEYWORD_TOKEN);
+      if (isStatic) this->consumeCurrentToken();
 
       this->skipSingleLineSpaceTokens();
     
       // get constant keyword
       isConstant = this->matchToken(Specification::TokenType::CONSTANT_KEYWORD_TOKEN);
+      if (isConstant) this->consumeCurrentToken();
     }
 
     this->skipSingleLineSpaceTokens();
@@ -1063,11 +1068,15 @@ namespace Parser {
       // shared terminators
       std::vector<Specification::TokenType> keyExpressionTerminators = {};
       keyExpressionTerminators.push_back(Specification::TokenType::COLON_TOKEN);
+      keyExpressionTerminators.push_back(Specification::TokenType::COMMA_TOKEN);
       keyExpressionTerminators.push_back(Specification::TokenType::RIGHT_CURLY_BRACE_TOKEN);
+      keyExpressionTerminators.push_back(Specification::TokenType::NEWLINE_TOKEN);
 
       std::vector<Specification::TokenType> valueExpressionTerminators = {};
       valueExpressionTerminators.push_back(Specification::TokenType::COMMA_TOKEN);
       valueExpressionTerminators.push_back(Specification::TokenType::RIGHT_CURLY_BRACE_TOKEN);
+      // closing brace can be on the next line
+      valueExpressionTerminators.push_back(Specification::TokenType::NEWLINE_TOKEN);
 
       while (!this->isEnd() && !this->matchToken(Specification::TokenType::RIGHT_CURLY_BRACE_TOKEN)) {
         this->skipMultilineSpaceTokens();
@@ -1099,7 +1108,7 @@ namespace Parser {
 
           valueExpression = this->parseExpression(NULL, BASE_PRECEDENCE, valueExpressionTerminators);
 
-          if (Shared::Classes::isInstanceOf<AST::Expression, AST::NullExpression>(keyExpression)) {
+          if (Shared::Classes::isInstanceOf<AST::Expression, AST::NullExpression>(valueExpression)) {
             Base::Position position = this->getCurrentToken().getPosition();
             throw Exception(position, "Invalid value expression");
           }
@@ -1123,6 +1132,10 @@ namespace Parser {
         this->skipMultilineSpaceTokens();
       }
 
+      // consume closing token
+      this->requireToken(Specification::TokenType::RIGHT_CURLY_BRACE_TOKEN);
+      this->consumeCurrentToken();
+
       // compose expressions
       AST::AssociationExpression* associationExpression = new AST::AssociationExpression(operatorToken.getPosition(), entries);
 
@@ -11,9 +11,11 @@ namespace Resolution {
   ModulesLoader::ModulesLoader() {
     this->lexer = Lexer::Lexer();
     this->parser = Parser::Parser();
+    this->folder = Optimizer::ConstantFolder();
     this->registry = ModulesRegistry();
     this->pathAliases = {};
     this->loadingModulesPaths = {};
+    this->isConstantFoldingEnabled = Optimizer::IS_CONSTANT_FOLDING_ENABLED_BY_DEFAULT;
   }
 
   Module* ModulesLoader::getModuleByAbsolutePath(std::string absolutePath) {
@@ -23,6 +25,11 @@ namespace Resolution {
     std::vector<Lexer::Token> tokens = this->lexer.parse(sourceCode);
     AST::BlockStatement* content = this->parser.parse(tokens);
 
+    // optimize tree before execution
+    if (this->isConstantFoldingEnabled) {
+      this->folder.fold(content);
+    }
+
     // get dependencies
     std::vector<std::string> dependencies = this->getModuleDependencies(absolutePath, content);
 
@@ -68,6 +75,13 @@ namespace Resolution {
     this->pathAliases = aliases;
   }
 
+  bool ModulesLoader::getIsConstantFoldingEnabled() {
+    return this->isConstantFoldingEnabled;
+  }
+  void ModulesLoader::setIsConstantFoldingEnabled(bool isConstantFoldingEnabled) {
+    this->isConstantFoldingEnabled = isConstantFoldingEnabled;
+  }
+
   void ModulesLoader::loadModulesFromEntrypointPath(std::string path) {
     // do not load module again
     if (this->registry.isModuleAddedByPath(path)) return;
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "resolution/registry.h"
+#include "optimizer/folder.h"
 #include "parser/parser.h"
 #include "lexer/lexer.h"
 
@@ -18,8 +19,12 @@ namespace Resolution {
       // module instances
       Lexer::Lexer lexer;
       Parser::Parser parser;
+      Optimizer::ConstantFolder folder;
       ModulesRegistry registry;
 
+      // folding can be disabled to debug executor on the original tree
+      bool isConstantFoldingEnabled;
+
       // define path aliases
       std::unordered_map<std::string, std::string> pathAliases;
 
@@ -36,6 +41,9 @@ namespace Resolution {
       
       // sets path aliases
       void loadPathAliases(std::unordered_map<std::string, std::string>);
+
+      bool getIsConstantFoldingEnabled();
+      void setIsConstantFoldingEnabled(bool);
       
       // recursively loads modules starting with provided entry module path
       void loadModulesFromEntrypointPath(std::string);
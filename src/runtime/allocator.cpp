@@ -0,0 +1,134 @@
+#include "runtime/allocator.h"
+
+#include <new>
+
+namespace Runtime {
+  SlabAllocator::SlabAllocator(int slotSize) {
+    this->slotSize = slotSize;
+    this->slabs = {};
+    this->freeList = NULL;
+    this->liveSlotsAmount = 0;
+    this->freeSlotsAmount = 0;
+  }
+  SlabAllocator::~SlabAllocator() {
+    for (int i = 0; i < this->slabs.size(); i++) {
+      ::operator delete(this->slabs[i]);
+    }
+  }
+
+  void SlabAllocator::addSlab() {
+    char* slab = (char*)::operator new((size_t)this->slotSize * ALLOCATOR_SLAB_SLOTS_AMOUNT);
+    this->slabs.push_back(slab);
+
+    // link slots in address order
+    for (int i = ALLOCATOR_SLAB_SLOTS_AMOUNT - 1; i >= 0; i--) {
+      void* slot = slab + (size_t)i * this->slotSize;
+      *(void**)slot = this->freeList;
+      this->freeList = slot;
+    }
+
+    this->freeSlotsAmount += ALLOCATOR_SLAB_SLOTS_AMOUNT;
+  }
+
+  void* SlabAllocator::allocate() {
+    if (this->freeList == NULL) {
+      this->addSlab();
+    }
+
+    void* slot = this->freeList;
+    this->freeList = *(void**)slot;
+
+    this->liveSlotsAmount++;
+    this->freeSlotsAmount--;
+
+    return slot;
+  }
+  void SlabAllocator::deallocate(void* slot) {
+    *(void**)slot = this->freeList;
+    this->freeList = slot;
+
+    this->liveSlotsAmount--;
+    this->freeSlotsAmount++;
+  }
+
+  int SlabAllocator::getSlotSize() {
+    return this->slotSize;
+  }
+  int SlabAllocator::getLiveSlotsAmount() {
+    return this->liveSlotsAmount;
+  }
+  int SlabAllocator::getFreeSlotsAmount() {
+    return this->freeSlotsAmount;
+  }
+  int SlabAllocator::getSlabsAmount() {
+    return this->slabs.size();
+  }
+
+  Allocator::Allocator() {
+    this->sizeClasses = {};
+    this->systemAllocationsAmount = 0;
+
+    for (int i = 1; i <= ALLOCATOR_SIZE_CLASSES_AMOUNT; i++) {
+      this->sizeClasses.push_back(new SlabAllocator(i * ALLOCATOR_SIZE_CLASS_STEP));
+    }
+  }
+  Allocator::~Allocator() {
+    for (int i = 0; i < this->sizeClasses.size(); i++) {
+      delete this->sizeClasses[i];
+    }
+  }
+
+  SlabAllocator* Allocator::getSizeClass(size_t size) {
+    #ifdef RUNTIME_ALLOCATOR_SYSTEM_ONLY
+      return NULL;
+    #endif
+
+    int index = (size + ALLOCATOR_SIZE_CLASS_STEP - 1) / ALLOCATOR_SIZE_CLASS_STEP - 1;
+    if (index < 0) index = 0;
+    if (index >= this->sizeClasses.size()) return NULL;
+
+    return this->sizeClasses[index];
+  }
+
+  void* Allocator::allocate(size_t size) {
+    SlabAllocator* sizeClass = this->getSizeClass(size);
+    if (sizeClass != NULL) return sizeClass->allocate();
+
+    this->systemAllocationsAmount++;
+    return ::operator new(size);
+  }
+  void Allocator::deallocate(void* pointer, size_t size) {
+    SlabAllocator* sizeClass = this->getSizeClass(size);
+    if (sizeClass != NULL) return sizeClass->deallocate(pointer);
+
+    this->systemAllocationsAmount--;
+    ::operator delete(pointer);
+  }
+
+  int Allocator::getLiveSlotsAmount() {
+    int amount = 0;
+    for (int i = 0; i < this->sizeClasses.size(); i++) {
+      amount += this->sizeClasses[i]->getLiveSlotsAmount();
+    }
+    return amount;
+  }
+  int Allocator::getFreeSlotsAmount() {
+    int amount = 0;
+    for (int i = 0; i < this->sizeClasses.size(); i++) {
+      amount += this->sizeClasses[i]->getFreeSlotsAmount();
+    }
+    return amount;
+  }
+  int Allocator::getSystemAllocationsAmount() {
+    return this->systemAllocationsAmount;
+  }
+  const std::vector<SlabAllocator*>& Allocator::getSizeClasses() {
+    return this->sizeClasses;
+  }
+
+  Allocator& Allocator::getInstance() {
+    // constructed on first use, so objects can be allocated during static initialization
+    static Allocator allocator;
+    return allocator;
+  }
+}
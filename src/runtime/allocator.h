@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// sanitizer builds allocate every object by system allocator to keep memory errors detection
+#if defined(__SANITIZE_ADDRESS__)
+  #define RUNTIME_ALLOCATOR_SYSTEM_ONLY
+#elif defined(__has_feature)
+  #if __has_feature(address_sanitizer)
+    #define RUNTIME_ALLOCATOR_SYSTEM_ONLY
+  #endif
+#endif
+
+namespace Runtime {
+  // size classes of slab allocation
+  // slots sizes are multiples of the step (it keeps slots aligned)
+  inline const int ALLOCATOR_SIZE_CLASS_STEP = 16;
+  inline const int ALLOCATOR_SIZE_CLASSES_AMOUNT = 16;
+  // amount of slots allocated at once for a size class
+  inline const int ALLOCATOR_SLAB_SLOTS_AMOUNT = 256;
+
+  // allocates fixed size slots from slabs
+  // freed slots are linked into free list and are reused without system allocator
+  class SlabAllocator {
+    private:
+      int slotSize;
+
+      // slabs are released only with allocator
+      std::vector<char*> slabs;
+      // free list is stored inside of free slots
+      void* freeList;
+
+      int liveSlotsAmount;
+      int freeSlotsAmount;
+
+      // allocates slab and puts its slots to free list
+      void addSlab();
+
+    public:
+      SlabAllocator(int slotSize);
+      SlabAllocator(const SlabAllocator&) = delete;
+      ~SlabAllocator();
+
+      void* allocate();
+      void deallocate(void*);
+
+      int getSlotSize();
+      int getLiveSlotsAmount();
+      int getFreeSlotsAmount();
+      int getSlabsAmount();
+  };
+
+  // allocator of memory managed objects (values and containers)
+  // routes allocation to slab allocator of the size class
+  // sizes above the largest size class are allocated by system allocator
+  class Allocator {
+    private:
+      std::vector<SlabAllocator*> sizeClasses;
+
+      // amount of objects allocated by system allocator
+      int systemAllocationsAmount;
+
+      // returns NULL if the size does not fit size classes
+      SlabAllocator* getSizeClass(size_t);
+
+    public:
+      Allocator();
+      Allocator(const Allocator&) = delete;
+      ~Allocator();
+
+      void* allocate(size_t);
+      void deallocate(void*, size_t);
+
+      // stats of all size classes
+      int getLiveSlotsAmount();
+      int getFreeSlotsAmount();
+      int getSystemAllocationsAmount();
+
+      const std::vector<SlabAllocator*>& getSizeClasses();
+
+      // allocator is shared by all objects as it is used by their operator new
+      static Allocator& getInstance();
+  };
+}
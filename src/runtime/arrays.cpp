@@ -0,0 +1,551 @@
+#include "runtime/arrays.h"
+
+#include <cstdint>
+
+#ifdef RUNTIME_ARRAYS_AVX2
+  #include <immintrin.h>
+
+  // AVX2 kernels are compiled for AVX2 only, the rest of the program stays generic
+  #define RUNTIME_ARRAYS_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace Runtime {
+  // scalar kernels are used as fallback and for tails of vectorized loops
+  namespace Scalar {
+    // signed overflow is undefined, so int64 arithmetic is done on unsigned values
+    int64_t wrappingAdd(int64_t left, int64_t right) {
+      return (int64_t)((uint64_t)left + (uint64_t)right);
+    }
+    int64_t wrappingSubtract(int64_t left, int64_t right) {
+      return (int64_t)((uint64_t)left - (uint64_t)right);
+    }
+    int64_t wrappingMultiply(int64_t left, int64_t right) {
+      return (int64_t)((uint64_t)left * (uint64_t)right);
+    }
+
+    double sumFloat64(const double* items, int size) {
+      double sum = 0;
+      for (int i = 0; i < size; i++) {
+        sum += items[i];
+      }
+      return sum;
+    }
+    double minFloat64(const double* items, int size) {
+      double min = items[0];
+      for (int i = 1; i < size; i++) {
+        min = items[i] < min ? items[i] : min;
+      }
+      return min;
+    }
+    double maxFloat64(const double* items, int size) {
+      double max = items[0];
+      for (int i = 1; i < size; i++) {
+        max = items[i] > max ? items[i] : max;
+      }
+      return max;
+    }
+    double dotFloat64(const double* left, const double* right, int size) {
+      double sum = 0;
+      for (int i = 0; i < size; i++) {
+        sum += left[i] * right[i];
+      }
+      return sum;
+    }
+    void axpyFloat64(double alpha, const double* x, double* y, int size) {
+      for (int i = 0; i < size; i++) {
+        y[i] += alpha * x[i];
+      }
+    }
+    void addFloat64(const double* left, const double* right, double* result, int size) {
+      for (int i = 0; i < size; i++) {
+        result[i] = left[i] + right[i];
+      }
+    }
+    void subtractFloat64(const double* left, const double* right, double* result, int size) {
+      for (int i = 0; i < size; i++) {
+        result[i] = left[i] - right[i];
+      }
+    }
+    void multiplyFloat64(const double* left, const double* right, double* result, int size) {
+      for (int i = 0; i < size; i++) {
+        result[i] = left[i] * right[i];
+      }
+    }
+    void divideFloat64(const double* left, const double* right, double* result, int size) {
+      for (int i = 0; i < size; i++) {
+        result[i] = left[i] / right[i];
+      }
+    }
+    void scaleFloat64(double factor, double* items, int size) {
+      for (int i = 0; i < size; i++) {
+        items[i] *= factor;
+      }
+    }
+    void prefixSumFloat64(const double* items, double* result, int size, double carry) {
+      for (int i = 0; i < size; i++) {
+        carry += items[i];
+        result[i] = carry;
+      }
+    }
+
+    int64_t sumInt64(const int64_t* items, int size) {
+      int64_t sum = 0;
+      for (int i = 0; i < size; i++) {
+        sum = wrappingAdd(sum, items[i]);
+      }
+      return sum;
+    }
+    int64_t minInt64(const int64_t* items, int size) {
+      int64_t min = items[0];
+      for (int i = 1; i < size; i++) {
+        min = items[i] < min ? items[i] : min;
+      }
+      return min;
+    }
+    int64_t maxInt64(const int64_t* items, int size) {
+      int64_t max = items[0];
+      for (int i = 1; i < size; i++) {
+        max = items[i] > max ? items[i] : max;
+      }
+      return max;
+    }
+    void addInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+      for (int i = 0; i < size; i++) {
+        result[i] = wrappingAdd(left[i], right[i]);
+      }
+    }
+    void subtractInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+      for (int i = 0; i < size; i++) {
+        result[i] = wrappingSubtract(left[i], right[i]);
+      }
+    }
+    void prefixSumInt64(const int64_t* items, int64_t* result, int size, int64_t carry) {
+      for (int i = 0; i < size; i++) {
+        carry = wrappingAdd(carry, items[i]);
+        result[i] = carry;
+      }
+    }
+  }
+
+#ifdef RUNTIME_ARRAYS_AVX2
+  // loops process 4 items per register, remaining items are processed by scalar kernels
+  // loads are unaligned as kernels get raw pointers, on aligned arrays they are as fast as aligned ones
+  namespace Avx2 {
+    RUNTIME_ARRAYS_AVX2_TARGET double horizontalSum(__m256d vector) {
+      __m128d low = _mm_add_pd(_mm256_castpd256_pd128(vector), _mm256_extractf128_pd(vector, 1));
+      return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+    }
+
+    RUNTIME_ARRAYS_AVX2_TARGET double sumFloat64(const double* items, int size) {
+      // two accumulators hide latency of additions
+      __m256d first = _mm256_setzero_pd();
+      __m256d second = _mm256_setzero_pd();
+
+      int i = 0;
+      for (; i + 8 <= size; i += 8) {
+        first = _mm256_add_pd(first, _mm256_loadu_pd(items + i));
+        second = _mm256_add_pd(second, _mm256_loadu_pd(items + i + 4));
+      }
+      for (; i + 4 <= size; i += 4) {
+        first = _mm256_add_pd(first, _mm256_loadu_pd(items + i));
+      }
+
+      return horizontalSum(_mm256_add_pd(first, second)) + Scalar::sumFloat64(items + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET double minFloat64(const double* items, int size) {
+      if (size < 4) return Scalar::minFloat64(items, size);
+
+      __m256d min = _mm256_loadu_pd(items);
+
+      int i = 4;
+      for (; i + 4 <= size; i += 4) {
+        min = _mm256_min_pd(_mm256_loadu_pd(items + i), min);
+      }
+
+      double lanes[4];
+      _mm256_storeu_pd(lanes, min);
+
+      double result = Scalar::minFloat64(lanes, 4);
+      for (; i < size; i++) {
+        result = items[i] < result ? items[i] : result;
+      }
+
+      return result;
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET double maxFloat64(const double* items, int size) {
+      if (size < 4) return Scalar::maxFloat64(items, size);
+
+      __m256d max = _mm256_loadu_pd(items);
+
+      int i = 4;
+      for (; i + 4 <= size; i += 4) {
+        max = _mm256_max_pd(_mm256_loadu_pd(items + i), max);
+      }
+
+      double lanes[4];
+      _mm256_storeu_pd(lanes, max);
+
+      double result = Scalar::maxFloat64(lanes, 4);
+      for (; i < size; i++) {
+        result = items[i] > result ? items[i] : result;
+      }
+
+      return result;
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET double dotFloat64(const double* left, const double* right, int size) {
+      __m256d first = _mm256_setzero_pd();
+      __m256d second = _mm256_setzero_pd();
+
+      int i = 0;
+      for (; i + 8 <= size; i += 8) {
+        first = _mm256_add_pd(first, _mm256_mul_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+        second = _mm256_add_pd(second, _mm256_mul_pd(_mm256_loadu_pd(left + i + 4), _mm256_loadu_pd(right + i + 4)));
+      }
+      for (; i + 4 <= size; i += 4) {
+        first = _mm256_add_pd(first, _mm256_mul_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+      }
+
+      return horizontalSum(_mm256_add_pd(first, second)) + Scalar::dotFloat64(left + i, right + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void axpyFloat64(double alpha, const double* x, double* y, int size) {
+      __m256d factor = _mm256_set1_pd(alpha);
+
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        __m256d product = _mm256_mul_pd(factor, _mm256_loadu_pd(x + i));
+        _mm256_storeu_pd(y + i, _mm256_add_pd(product, _mm256_loadu_pd(y + i)));
+      }
+
+      Scalar::axpyFloat64(alpha, x + i, y + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void addFloat64(const double* left, const double* right, double* result, int size) {
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(result + i, _mm256_add_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+      }
+
+      Scalar::addFloat64(left + i, right + i, result + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void subtractFloat64(const double* left, const double* right, double* result, int size) {
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(result + i, _mm256_sub_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+      }
+
+      Scalar::subtractFloat64(left + i, right + i, result + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void multiplyFloat64(const double* left, const double* right, double* result, int size) {
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(result + i, _mm256_mul_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+      }
+
+      Scalar::multiplyFloat64(left + i, right + i, result + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void divideFloat64(const double* left, const double* right, double* result, int size) {
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(result + i, _mm256_div_pd(_mm256_loadu_pd(left + i), _mm256_loadu_pd(right + i)));
+      }
+
+      Scalar::divideFloat64(left + i, right + i, result + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void scaleFloat64(double factor, double* items, int size) {
+      __m256d factors = _mm256_set1_pd(factor);
+
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        _mm256_storeu_pd(items + i, _mm256_mul_pd(_mm256_loadu_pd(items + i), factors));
+      }
+
+      Scalar::scaleFloat64(factor, items + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void prefixSumFloat64(const double* items, double* result, int size) {
+      __m256d zero = _mm256_setzero_pd();
+      // running total broadcasted to all lanes
+      __m256d carry = zero;
+
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        __m256d sums = _mm256_loadu_pd(items + i);
+
+        // scan in register: [a, b, c, d] -> [a, a+b, b+c, c+d] -> [a, a+b, a+b+c, a+b+c+d]
+        sums = _mm256_add_pd(sums, _mm256_blend_pd(_mm256_permute4x64_pd(sums, _MM_SHUFFLE(2, 1, 0, 3)), zero, 0x1));
+        sums = _mm256_add_pd(sums, _mm256_blend_pd(_mm256_permute4x64_pd(sums, _MM_SHUFFLE(1, 0, 3, 2)), zero, 0x3));
+        sums = _mm256_add_pd(sums, carry);
+
+        _mm256_storeu_pd(result + i, sums);
+        carry = _mm256_permute4x64_pd(sums, _MM_SHUFFLE(3, 3, 3, 3));
+      }
+
+      Scalar::prefixSumFloat64(items + i, result + i, size - i, i > 0 ? result[i - 1] : 0);
+    }
+
+    RUNTIME_ARRAYS_AVX2_TARGET int64_t sumInt64(const int64_t* items, int size) {
+      __m256i sums = _mm256_setzero_si256();
+
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        sums = _mm256_add_epi64(sums, _mm256_loadu_si256((const __m256i*)(items + i)));
+      }
+
+      int64_t lanes[4];
+      _mm256_storeu_si256((__m256i*)lanes, sums);
+
+      return Scalar::wrappingAdd(Scalar::sumInt64(lanes, 4), Scalar::sumInt64(items + i, size - i));
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET int64_t minInt64(const int64_t* items, int size) {
+      if (size < 4) return Scalar::minInt64(items, size);
+
+      __m256i min = _mm256_loadu_si256((const __m256i*)items);
+
+      // AVX2 has no 64-bit min, lanes are selected by comparison
+      int i = 4;
+      for (; i + 4 <= size; i += 4) {
+        __m256i current = _mm256_loadu_si256((const __m256i*)(items + i));
+        min = _mm256_blendv_epi8(min, current, _mm256_cmpgt_epi64(min, current));
+      }
+
+      int64_t lanes[4];
+      _mm256_storeu_si256((__m256i*)lanes, min);
+
+      int64_t result = Scalar::minInt64(lanes, 4);
+      for (; i < size; i++) {
+        result = items[i] < result ? items[i] : result;
+      }
+
+      return result;
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET int64_t maxInt64(const int64_t* items, int size) {
+      if (size < 4) return Scalar::maxInt64(items, size);
+
+      __m256i max = _mm256_loadu_si256((const __m256i*)items);
+
+      int i = 4;
+      for (; i + 4 <= size; i += 4) {
+        __m256i current = _mm256_loadu_si256((const __m256i*)(items + i));
+        max = _mm256_blendv_epi8(max, current, _mm256_cmpgt_epi64(current, max));
+      }
+
+      int64_t lanes[4];
+      _mm256_storeu_si256((__m256i*)lanes, max);
+
+      int64_t result = Scalar::maxInt64(lanes, 4);
+      for (; i < size; i++) {
+        result = items[i] > result ? items[i] : result;
+      }
+
+      return result;
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void addInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        __m256i sum = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)(left + i)), _mm256_loadu_si256((const __m256i*)(right + i)));
+        _mm256_storeu_si256((__m256i*)(result + i), sum);
+      }
+
+      Scalar::addInt64(left + i, right + i, result + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void subtractInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        __m256i difference = _mm256_sub_epi64(_mm256_loadu_si256((const __m256i*)(left + i)), _mm256_loadu_si256((const __m256i*)(right + i)));
+        _mm256_storeu_si256((__m256i*)(result + i), difference);
+      }
+
+      Scalar::subtractInt64(left + i, right + i, result + i, size - i);
+    }
+    RUNTIME_ARRAYS_AVX2_TARGET void prefixSumInt64(const int64_t* items, int64_t* result, int size) {
+      __m256i zero = _mm256_setzero_si256();
+      __m256i carry = zero;
+
+      int i = 0;
+      for (; i + 4 <= size; i += 4) {
+        __m256i sums = _mm256_loadu_si256((const __m256i*)(items + i));
+
+        // the same scan as for floats, blend masks select 32-bit halves of 64-bit lanes
+        sums = _mm256_add_epi64(sums, _mm256_blend_epi32(_mm256_permute4x64_epi64(sums, _MM_SHUFFLE(2, 1, 0, 3)), zero, 0x03));
+        sums = _mm256_add_epi64(sums, _mm256_blend_epi32(_mm256_permute4x64_epi64(sums, _MM_SHUFFLE(1, 0, 3, 2)), zero, 0x0F));
+        sums = _mm256_add_epi64(sums, carry);
+
+        _mm256_storeu_si256((__m256i*)(result + i), sums);
+        carry = _mm256_permute4x64_epi64(sums, _MM_SHUFFLE(3, 3, 3, 3));
+      }
+
+      Scalar::prefixSumInt64(items + i, result + i, size - i, i > 0 ? result[i - 1] : 0);
+    }
+  }
+#endif
+
+  bool areArrayKernelsVectorized() {
+#ifdef RUNTIME_ARRAYS_AVX2
+    static const bool isSupported = __builtin_cpu_supports("avx2");
+    return isSupported;
+#else
+    return false;
+#endif
+  }
+
+  double sumFloat64(const double* items, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) return Avx2::sumFloat64(items, size);
+#endif
+    return Scalar::sumFloat64(items, size);
+  }
+  double minFloat64(const double* items, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) return Avx2::minFloat64(items, size);
+#endif
+    return Scalar::minFloat64(items, size);
+  }
+  double maxFloat64(const double* items, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) return Avx2::maxFloat64(items, size);
+#endif
+    return Scalar::maxFloat64(items, size);
+  }
+  double dotFloat64(const double* left, const double* right, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) return Avx2::dotFloat64(left, right, size);
+#endif
+    return Scalar::dotFloat64(left, right, size);
+  }
+  void axpyFloat64(double alpha, const double* x, double* y, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::axpyFloat64(alpha, x, y, size);
+      return;
+    }
+#endif
+    Scalar::axpyFloat64(alpha, x, y, size);
+  }
+  void addFloat64(const double* left, const double* right, double* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::addFloat64(left, right, result, size);
+      return;
+    }
+#endif
+    Scalar::addFloat64(left, right, result, size);
+  }
+  void subtractFloat64(const double* left, const double* right, double* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::subtractFloat64(left, right, result, size);
+      return;
+    }
+#endif
+    Scalar::subtractFloat64(left, right, result, size);
+  }
+  void multiplyFloat64(const double* left, const double* right, double* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::multiplyFloat64(left, right, result, size);
+      return;
+    }
+#endif
+    Scalar::multiplyFloat64(left, right, result, size);
+  }
+  void divideFloat64(const double* left, const double* right, double* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::divideFloat64(left, right, result, size);
+      return;
+    }
+#endif
+    Scalar::divideFloat64(left, right, result, size);
+  }
+  void scaleFloat64(double factor, double* items, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::scaleFloat64(factor, items, size);
+      return;
+    }
+#endif
+    Scalar::scaleFloat64(factor, items, size);
+  }
+  void prefixSumFloat64(const double* items, double* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::prefixSumFloat64(items, result, size);
+      return;
+    }
+#endif
+    Scalar::prefixSumFloat64(items, result, size, 0);
+  }
+
+  int64_t sumInt64(const int64_t* items, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) return Avx2::sumInt64(items, size);
+#endif
+    return Scalar::sumInt64(items, size);
+  }
+  int64_t minInt64(const int64_t* items, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) return Avx2::minInt64(items, size);
+#endif
+    return Scalar::minInt64(items, size);
+  }
+  int64_t maxInt64(const int64_t* items, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) return Avx2::maxInt64(items, size);
+#endif
+    return Scalar::maxInt64(items, size);
+  }
+  int64_t dotInt64(const int64_t* left, const int64_t* right, int size) {
+    int64_t sum = 0;
+    for (int i = 0; i < size; i++) {
+      sum = Scalar::wrappingAdd(sum, Scalar::wrappingMultiply(left[i], right[i]));
+    }
+    return sum;
+  }
+  void axpyInt64(int64_t alpha, const int64_t* x, int64_t* y, int size) {
+    for (int i = 0; i < size; i++) {
+      y[i] = Scalar::wrappingAdd(y[i], Scalar::wrappingMultiply(alpha, x[i]));
+    }
+  }
+  void addInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::addInt64(left, right, result, size);
+      return;
+    }
+#endif
+    Scalar::addInt64(left, right, result, size);
+  }
+  void subtractInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::subtractInt64(left, right, result, size);
+      return;
+    }
+#endif
+    Scalar::subtractInt64(left, right, result, size);
+  }
+  void multiplyInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+    for (int i = 0; i < size; i++) {
+      result[i] = Scalar::wrappingMultiply(left[i], right[i]);
+    }
+  }
+  void divideInt64(const int64_t* left, const int64_t* right, int64_t* result, int size) {
+    for (int i = 0; i < size; i++) {
+      // the only overflowing division wraps to the dividend negated
+      if (right[i] == -1) result[i] = Scalar::wrappingSubtract(0, left[i]);
+      else result[i] = left[i] / right[i];
+    }
+  }
+  void scaleInt64(int64_t factor, int64_t* items, int size) {
+    for (int i = 0; i < size; i++) {
+      items[i] = Scalar::wrappingMultiply(items[i], factor);
+    }
+  }
+  void prefixSumInt64(const int64_t* items, int64_t* result, int size) {
+#ifdef RUNTIME_ARRAYS_AVX2
+    if (areArrayKernelsVectorized()) {
+      Avx2::prefixSumInt64(items, result, size);
+      return;
+    }
+#endif
+    Scalar::prefixSumInt64(items, result, size, 0);
+  }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+// kernels use AVX2 if the processor supports it (it is checked once at runtime)
+// scalar kernels are used on other platforms or if scalar build is requested
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(RUNTIME_ARRAYS_SCALAR_ONLY)
+  #define RUNTIME_ARRAYS_AVX2
+#endif
+
+namespace Runtime {
+  // items of typed arrays are aligned for vector loads (AVX2 register is 32 bytes)
+  inline const size_t ARRAY_ALIGNMENT = 32;
+
+  // fixed size contiguous storage of unboxed numbers
+  // items are zeroed on creation
+  // methods are defined in the header as storage is generic
+  template<typename Item>
+  class AlignedArray {
+    private:
+      Item* data;
+      int size;
+
+    public:
+      AlignedArray(int size): data(NULL), size(size) {
+        if (size == 0) return;
+
+        this->data = static_cast<Item*>(::operator new(size * sizeof(Item), std::align_val_t(ARRAY_ALIGNMENT)));
+        std::memset(this->data, 0, size * sizeof(Item));
+      }
+      ~AlignedArray() {
+        if (this->data != NULL) ::operator delete(this->data, std::align_val_t(ARRAY_ALIGNMENT));
+      }
+
+      AlignedArray(const AlignedArray&) = delete;
+      AlignedArray& operator=(const AlignedArray&) = delete;
+
+      Item* getData() {
+        return this->data;
+      }
+      int getSize() const {
+        return this->size;
+      }
+  };
+
+  // returns if AVX2 kernels are used
+  bool areArrayKernelsVectorized();
+
+  // kernels of float64 arrays
+  // vectorized reductions sum items in several accumulators, so results can differ from scalar order in the last bits
+  // min and max are computed for non-empty arrays only
+  double sumFloat64(const double* items, int size);
+  double minFloat64(const double* items, int size);
+  double maxFloat64(const double* items, int size);
+  double dotFloat64(const double* left, const double* right, int size);
+  // y = alpha * x + y
+  void axpyFloat64(double alpha, const double* x, double* y, int size);
+  // elementwise operations write to result (it can be one of operands)
+  void addFloat64(const double* left, const double* right, double* result, int size);
+  void subtractFloat64(const double* left, const double* right, double* result, int size);
+  void multiplyFloat64(const double* left, const double* right, double* result, int size);
+  void divideFloat64(const double* left, const double* right, double* result, int size);
+  void scaleFloat64(double factor, double* items, int size);
+  void prefixSumFloat64(const double* items, double* result, int size);
+
+  // kernels of int64 arrays
+  // arithmetic wraps on overflow
+  // AVX2 has no 64-bit multiplication, so dot, axpy, multiply and scale are scalar
+  // divisors are validated by the caller (no zeros)
+  int64_t sumInt64(const int64_t* items, int size);
+  int64_t minInt64(const int64_t* items, int size);
+  int64_t maxInt64(const int64_t* items, int size);
+  int64_t dotInt64(const int64_t* left, const int64_t* right, int size);
+  void axpyInt64(int64_t alpha, const int64_t* x, int64_t* y, int size);
+  void addInt64(const int64_t* left, const int64_t* right, int64_t* result, int size);
+  void subtractInt64(const int64_t* left, const int64_t* right, int64_t* result, int size);
+  void multiplyInt64(const int64_t* left, const int64_t* right, int64_t* result, int size);
+  void divideInt64(const int64_t* left, const int64_t* right, int64_t* result, int size);
+  void scaleInt64(int64_t factor, int64_t* items, int size);
+  void prefixSumInt64(const int64_t* items, int64_t* result, int size);
+}
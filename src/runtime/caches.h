@@ -0,0 +1,122 @@
+#pragma once
+
+#include "runtime/tagged.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Runtime {
+  class Shape;
+
+  // returned by lookup if the site has not resolved the member for a layout
+  inline const int MEMBER_CACHE_MISS = -1;
+  // site that sees more layouts than this is megamorphic and is not cached anymore
+  inline const int MAXIMUM_MEMBER_CACHE_ENTRIES = 4;
+
+  // member resolved for a layout in a context class
+  // slot is the index of the field that passed access checks
+  // classes are identified by their identities, as their addresses are reused after release (shapes are never released)
+  // identity 0 is used for shapes and for code outside of classes
+  struct MemberCacheEntry {
+    DataType structureType;
+    const void* layout;
+    uint64_t layoutIdentity;
+    uint64_t contextIdentity;
+    int slot;
+
+    bool isSame(DataType structureType, const void* layout, uint64_t layoutIdentity, uint64_t contextIdentity) const {
+      return this->layout == layout && this->layoutIdentity == layoutIdentity && this->contextIdentity == contextIdentity && this->structureType == structureType;
+    }
+  };
+
+  // inline cache of member access site
+  // one entry makes the site monomorphic, more entries make it polymorphic
+  // methods are defined in the header to be inlined in member access
+  class MemberCache {
+    private:
+      MemberCacheEntry entries[MAXIMUM_MEMBER_CACHE_ENTRIES];
+      int entriesAmount;
+      bool isMegamorphic;
+
+    public:
+      MemberCache(): entries(), entriesAmount(0), isMegamorphic(false) {}
+
+      bool getIsMonomorphic() const {
+        return this->entriesAmount == 1;
+      }
+      bool getIsPolymorphic() const {
+        return this->entriesAmount > 1;
+      }
+      bool getIsMegamorphic() const {
+        return this->isMegamorphic;
+      }
+
+      // returns cached slot or MEMBER_CACHE_MISS
+      int lookup(DataType structureType, const void* layout, uint64_t layoutIdentity, uint64_t contextIdentity) const {
+        for (int i = 0; i < this->entriesAmount; i++) {
+          const MemberCacheEntry& entry = this->entries[i];
+          if (entry.isSame(structureType, layout, layoutIdentity, contextIdentity)) return entry.slot;
+        }
+
+        return MEMBER_CACHE_MISS;
+      }
+
+      // stores slot resolved by generic lookup
+      void record(DataType structureType, const void* layout, uint64_t layoutIdentity, uint64_t contextIdentity, int slot) {
+        if (this->isMegamorphic) return;
+
+        // stale entry of the same layout is replaced
+        for (int i = 0; i < this->entriesAmount; i++) {
+          MemberCacheEntry& entry = this->entries[i];
+          if (entry.isSame(structureType, layout, layoutIdentity, contextIdentity)) {
+            entry.slot = slot;
+            return;
+          }
+        }
+
+        if (this->entriesAmount == MAXIMUM_MEMBER_CACHE_ENTRIES) {
+          this->isMegamorphic = true;
+          this->entriesAmount = 0;
+          return;
+        }
+
+        this->entries[this->entriesAmount++] = { structureType, layout, layoutIdentity, contextIdentity, slot };
+      }
+  };
+
+  // layout of object literal site
+  // literal with constant keys creates objects with the same entries, so the layout is resolved once
+  // slots are indexed by literal entries (repeated key takes the slot of the first one)
+  // literal with many entries is marked as dictionary, its objects are not given the shape
+  class LiteralShapeCache {
+    private:
+      Shape* shape;
+      std::vector<int> slots;
+      bool isResolved;
+      bool isDictionary;
+
+    public:
+      LiteralShapeCache(): shape(NULL), slots(), isResolved(false), isDictionary(false) {}
+
+      bool getIsResolved() const {
+        return this->isResolved;
+      }
+      bool getIsDictionary() const {
+        return this->isDictionary;
+      }
+      Shape* getShape() const {
+        return this->shape;
+      }
+      const std::vector<int>& getSlots() const {
+        return this->slots;
+      }
+
+      void resolve(Shape* shape, std::vector<int> slots, bool isDictionary) {
+        this->shape = shape;
+        this->slots = std::move(slots);
+        this->isDictionary = isDictionary;
+        this->isResolved = true;
+      }
+  };
+}
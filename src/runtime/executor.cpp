@@ -1,21 +1,29 @@
 #include "executor.h"
 #include "runtime/exceptions.h"
+#include "runtime/kernels.h"
 #include "runtime/signals.h"
 #include "shared/classes.h"
 #include "shared/vectors.h"
 
 #include <iostream>
+#include <cmath>
+#include <optional>
 
 namespace Runtime {
   Executor::Executor() {
     this->loader = Resolution::ModulesLoader();
-    this->memory = Memory();
+
+    this->currentContextClass = NULL;
+    this->currentContentObject = NULL;
   }
 
   void Executor::loadModulesFromEntrypoint(std::string absolutePath) {
     this->loader.loadModulesFromEntrypointPath(absolutePath);
     this->memory.prepareStructuresForModules(this->loader.getModules().size());
   }
+  void Executor::setIsConstantFoldingEnabled(bool isConstantFoldingEnabled) {
+    this->loader.setIsConstantFoldingEnabled(isConstantFoldingEnabled);
+  }
   void Executor::registerBuiltins(std::vector<Builtins::BuiltinModuleDeclarations> moduleDeclarations) {
     // execute declarations
     for (int m = 0; m < this->loader.getModules().size(); m++) {
@@ -97,32 +105,40 @@ namespace Runtime {
     this->addScopeInCurrentStack();
 
     for (int i = 0; i < statement->getStatements().size(); i++) {
-      this->executeStatement(statement->getStatements()[i]);
+      TemporariesMark temporariesMark = this->memory.getTemporariesMark();
+
+      // signals leave the block, so its scope has to be removed before passing them
+      try {
+        this->executeStatement(statement->getStatements()[i]);
+      }
+      catch (Signal& signal) {
+        this->removeScopeFromCurrentStack();
+        throw;
+      }
 
-      this->memory.clearTemporaryContainers();
-      this->memory.clearTemporaryValues();
+      this->memory.clearTemporaries(temporariesMark);
+      this->memory.collectCyclesOnThreshold();
     }
 
-    this->memory.removeUnreachableValues();
     this->removeScopeFromCurrentStack();
   }
   Container* Executor::executeVariableDeclarationStatement(AST::VariableDeclarationStatement* statement) {
-    Container* initialization = this->evaluateExpression(statement->getInitializer());
-    Container* variableContainer = new Container(statement->getName().getCode(), initialization->getValue());
+    ExpressionResult initialization = this->evaluateExpression(statement->getInitializer());
+    Container* variableContainer = new Container(statement->getName().getCode(), initialization.getValue());
 
     this->addContainerToCurrentStack(variableContainer);
     return variableContainer;
   }
   Container* Executor::executeConstantDeclarationStatement(AST::ConstantDeclarationStatement* statement) {
-    Container* initialization = this->evaluateExpression(statement->getInitializer());
-    Container* constantContainer = new Container(statement->getName().getCode(), initialization->getValue(), true);
+    ExpressionResult initialization = this->evaluateExpression(statement->getInitializer());
+    Container* constantContainer = new Container(statement->getName().getCode(), initialization.getValue(), true);
 
     this->addContainerToCurrentStack(constantContainer);
     return constantContainer;
   }
   void Executor::executeConditionStatement(AST::ConditionStatement *statement) {
-    Container* condition = this->evaluateExpression(statement->getCondition());
-    Value* conditionValue = condition->getValue();
+    ExpressionResult condition = this->evaluateExpression(statement->getCondition());
+    TaggedValue conditionValue = condition.getValue();
 
     if (getBoolean(conditionValue)) {
       this->executeStatement(statement->getThenBranch());
@@ -131,9 +147,14 @@ namespace Runtime {
     }
   }
   void Executor::executeWhileStatement(AST::WhileStatement *statement) {
+    TemporariesMark temporariesMark = this->memory.getTemporariesMark();
+
     while(true) {
-      Container* condition = this->evaluateExpression(statement->getCondition());
-      Value* conditionValue = condition->getValue();
+      // temporaries of the previous iteration are not used anymore
+      this->memory.clearTemporaries(temporariesMark);
+
+      ExpressionResult condition = this->evaluateExpression(statement->getCondition());
+      TaggedValue conditionValue = condition.getValue();
 
       if (!getBoolean(conditionValue)) break;
 
@@ -153,9 +174,14 @@ namespace Runtime {
 
     this->executeStatement(statement->getInitializer());
 
+    TemporariesMark temporariesMark = this->memory.getTemporariesMark();
+
     while(true) {
-      Container* condition = this->evaluateExpression(statement->getCondition());
-      Value* conditionValue = condition->getValue();
+      // temporaries of the previous iteration are not used anymore
+      this->memory.clearTemporaries(temporariesMark);
+
+      ExpressionResult condition = this->evaluateExpression(statement->getCondition());
+      TaggedValue conditionValue = condition.getValue();
 
       if (!getBoolean(conditionValue)) break;
 
@@ -169,6 +195,11 @@ namespace Runtime {
         this->evaluateExpression(statement->getIncrement());
         continue;
       }
+      // other signals leave the loop, so its scope has to be removed before passing them
+      catch (Signal& signal) {
+        this->removeScopeFromCurrentStack();
+        throw;
+      }
 
       this->evaluateExpression(statement->getIncrement());
     } 
@@ -182,98 +213,20 @@ namespace Runtime {
     throw ContinueSignal(statement);
   }
   Container* Executor::executeFunctionDeclarationStatement(AST::FunctionDeclarationStatement *statement) {
-    // retain all containers
-    std::vector<Container*> containersInCurrentStack = this->memory.getCurrentStack()->getContainers();
-    for (int i = 0; i < containersInCurrentStack.size(); i++) {
-      this->memory.retainContainer(containersInCurrentStack[i]);
-    }
-
-    // parse arguments amount
-    int totalArgumentsAmount = 0;
-    int optionalArgumentsAmount = 0;
-    bool isOptionalParamReached = false;
-
-    for (int i = 0; i < statement->getParams().size(); i++) {
-      if (statement->getParams()[i]->getDefaultValue() != NULL) {
-        isOptionalParamReached = true;
-        optionalArgumentsAmount++;
-      } else if (isOptionalParamReached) {
-        throw ExpressionException(statement->getParams()[i]->getPosition(), "Required argument goes after optional");
-      }
-      
-      totalArgumentsAmount++;
-    }
-
-    // compose function arguments
-    FunctionArgumentsAmount argumentsAmount(totalArgumentsAmount, optionalArgumentsAmount);
-    
-    // create closure
-    Stack* functionClosure = new Stack(this->copyCurrentStack());
-
-    // construct callable
-    Callable callable = [this, functionClosure, statement](std::vector<Value*> arguments) -> Value* {
-      // remember stack from where the function was called
-      Stack* callingStack = this->memory.getCurrentStack();
-
-      // TODO: set current context
-      
-      // assign context
-      // TODO: assign "this" value
-
-      // initialize argument values
-      std::vector<Value*> argumentValues = {};
-      for (int i = 0; i < statement->getParams().size(); i++) {
-        // if an argument is passed: use it
-        if (i < arguments.size()) {
-          argumentValues.push_back(arguments[i]);
-        }
-        // otherwise check default ones 
-        else {
-          argumentValues.push_back(this->evaluateExpression(statement->getParams()[i]->getDefaultValue())->getValue());
-        }  
-      }
-      
-      // go to function stack
-      this->memory.setCurrentStack(functionClosure);
-      this->addScopeInCurrentStack();
-      
-      // add argument containers to function stack
-      for (int i = 0; i < argumentValues.size(); i++) {
-        Container* argumentContainer = new Container(statement->getParams()[i]->getName().getCode(), argumentValues[i]);
-        this->addContainerToCurrentStack(argumentContainer);
-      }
-
-      // execute function body
-      try {
-        this->executeStatement(statement->getBody());
-      }
-      catch(ReturnSignal returnSignal) {
-        this->memory.retainValue(returnSignal.getValue());
-
-        // leave function stack
-        this->removeScopeFromCurrentStack();
-        this->memory.setCurrentStack(callingStack);
-
-        return returnSignal.getValue();
-      }
-
-      // leave function stack
-      this->removeScopeFromCurrentStack();
-      this->memory.setCurrentStack(callingStack);
-      
-      // default return
-      return new NullValue;
-    };
+    FunctionValue* functionValue = this->createScriptFunction(statement->getParams(), statement->getBody(), this->currentContentObject);
 
-    FunctionValue* functionValue = new FunctionValue(functionClosure, this->currentContentObject, callable, argumentsAmount);
-    Container* functionContainer = new Container(statement->getName().getCode(), functionValue, true);
+    Container* functionContainer = new Container(statement->getName().getCode(), TaggedValue::fromPointer(functionValue), true);
     this->addContainerToCurrentStack(functionContainer);
 
     return functionContainer;
   }
   void Executor::executeReturnStatement(AST::ReturnStatement *statement) {
-    Container* returnContainer = this->evaluateExpression(statement->getReturns());
-    throw ReturnSignal(statement, returnContainer->getValue());
+    ExpressionResult returnResult = this->evaluateExpression(statement->getReturns());
+
+    // returned value has to outlive scopes released while the signal is passed
+    // temporary value is not deleted on release and is cleared by the calling statement
+    this->memory.addTemporaryValue(returnResult.getValue());
+    throw ReturnSignal(statement, returnResult.getValue());
   }
   void Executor::executeImportStatement(AST::ImportStatement *statement) {
     if (!this->isExecutionOnTopLevel()) {
@@ -298,7 +251,7 @@ namespace Runtime {
 
     // check for exporting all symbols
     if (Shared::Vectors::includes(importTokenTypes, Specification::TokenType::MULTIPLICATION_TOKEN)) {
-      std::vector<Container*> exports = this->memory.getCurrentExportsRegistry()->getContainers();
+      const std::vector<Container*>& exports = this->memory.getCurrentExportsRegistry()->getContainers();
 
       for (int i = 0; i < exports.size(); i++) {
         Container* constantSymbol = new Container(exports[i]->getName(), exports[i]->getValue(), true);
@@ -338,25 +291,106 @@ namespace Runtime {
     throw StatementException(statement->getPosition(), "Invalid exporting statement");
   }
   Container* Executor::executeClassDeclarationStatement(AST::ClassDeclarationStatement* statement) {
-    // TODO: set current context
-    throw Exception("Not implemented");
+    // get parent classes
+    std::vector<ClassValue*> parents = {};
+    for (int i = 0; i < statement->getExtensionExpressions().size(); i++) {
+      AST::Expression* extensionExpression = statement->getExtensionExpressions()[i];
+      TaggedValue extension = this->evaluateExpression(extensionExpression).getValue();
+
+      if (extension.getType() != DataType::Class) {
+        throw TypeException(extensionExpression->getPosition(), "Class can extend only classes");
+      }
+
+      parents.push_back(Shared::Classes::cast<Value, ClassValue>(extension.getPointer()));
+    }
+
+    // hierarchy is linearized once, lookups use precomputed tables
+    std::optional<std::vector<ClassValue*>> parentsLinearization = linearizeParents(parents);
+    if (!parentsLinearization.has_value()) {
+      throw StatementException(statement->getPosition(), "Inconsistent class hierarchy");
+    }
+
+    ClassValue* classValue = new ClassValue(parents, parentsLinearization.value(), NULL, NULL);
+    for (int i = 0; i < parents.size(); i++) {
+      this->memory.retainValue(TaggedValue::fromPointer(parents[i]));
+    }
+
+    // class is declared before members, so methods can refer to it
+    Container* classContainer = new Container(statement->getName().getCode(), TaggedValue(), true);
+    this->addContainerToCurrentStack(classContainer);
+
+    // members are declared in the context of the class
+    ClassValue* previousContextClass = this->currentContextClass;
+    this->currentContextClass = classValue;
+
+    std::vector<Field> fields = {};
+    for (int i = 0; i < statement->getDeclarations().size(); i++) {
+      AST::ClassMemberDeclarationStatement* declaration = statement->getDeclarations()[i];
+      Field field = this->executeClassMemberDeclarationStatement(declaration, classValue);
+
+      for (int j = 0; j < fields.size(); j++) {
+        if (fields[j].getType() == field.getType() && fields[j].getKey().isSame(field.getKey())) {
+          throw StatementException(declaration->getPosition(), "Class member is already declared");
+        }
+      }
+
+      fields.push_back(field);
+    }
+
+    this->currentContextClass = previousContextClass;
+
+    classValue->setFields(fields);
+
+    // inherited fields hold own references to values of ancestors fields
+    const std::vector<Field>& classFields = classValue->getFields();
+    for (int i = 0; i < classFields.size(); i++) {
+      if (classFields[i].getClassOwner() != classValue) this->memory.retainValue(classFields[i].getValue());
+    }
+
+    this->handleContainerValueReassignment(classContainer, TaggedValue::fromPointer(classValue));
+    return classContainer;
+  }
+  Field Executor::executeClassMemberDeclarationStatement(AST::ClassMemberDeclarationStatement *statement, ClassValue* classValue) {
+    if (Shared::Classes::isInstanceOf<AST::ClassMemberDeclarationStatement, AST::ClassFieldDeclarationStatement>(statement)) {
+      return this->executeClassFieldDeclarationStatement(Shared::Classes::cast<AST::ClassMemberDeclarationStatement, AST::ClassFieldDeclarationStatement>(statement), classValue);
+    }
+    if (Shared::Classes::isInstanceOf<AST::ClassMemberDeclarationStatement, AST::ClassMethodDeclarationStatement>(statement)) {
+      return this->executeClassMethodDeclarationStatement(Shared::Classes::cast<AST::ClassMemberDeclarationStatement, AST::ClassMethodDeclarationStatement>(statement), classValue);
+    }
+
+    throw StatementException(statement->getPosition(), "Invalid class member");
   }
-  Container* Executor::executeClassMemberDeclarationStatement(AST::ClassMemberDeclarationStatement *statement) {
-    throw Exception("Not implemented");
+  Field Executor::executeClassFieldDeclarationStatement(AST::ClassFieldDeclarationStatement *statement, ClassValue* classValue) {
+    // field value is held by the class
+    TaggedValue value = this->memory.retainValue(this->evaluateExpression(statement->getInitialization()).getValue());
+    return this->createClassField(statement, classValue, value);
   }
-  Container* Executor::executeClassFieldDeclarationStatement(AST::ClassFieldDeclarationStatement *statement) {
-    // TODO: set current context
-    throw Exception("Not implemented");
+  Field Executor::executeClassMethodDeclarationStatement(AST::ClassMethodDeclarationStatement *statement, ClassValue* classValue) {
+    // methods are called in the context of their class
+    FunctionValue* methodValue = this->createScriptFunction(statement->getParams(), statement->getBody(), classValue);
+
+    TaggedValue value = this->memory.retainValue(TaggedValue::fromPointer(methodValue));
+    return this->createClassField(statement, classValue, value);
   }
-  Container* Executor::executeClassMethodDeclarationStatement(AST::ClassMethodDeclarationStatement *statement) {
-    throw Exception("Not implemented");
+  Field Executor::createClassField(AST::ClassMemberDeclarationStatement* statement, ClassValue* classValue, TaggedValue value) {
+    FieldAccess access = FieldAccess::PRIVATE;
+    if (statement->getAccessModifier() == Specification::TokenType::PUBLIC_KEYWORD_TOKEN) access = FieldAccess::PUBLIC;
+    if (statement->getAccessModifier() == Specification::TokenType::PROTECTED_KEYWORD_TOKEN) access = FieldAccess::PROTECTED;
+
+    FieldType type = statement->getIsStatic() ? FieldType::STATIC : FieldType::INSTANCE;
+    FieldMutability mutability = statement->getIsConstant() ? FieldMutability::CONSTANT : FieldMutability::VARIABLE;
+
+    // keys are interned, so class tables find them by pointer
+    TaggedValue key = this->memory.internString(statement->getName().getCode());
+
+    return Field(access, type, mutability, classValue, NULL, key, value);
   }
   void Executor::executeExpressionStatement(AST::ExpressionStatement *statement) {
     this->evaluateExpression(statement->getExpression());
   }
 
   // expressions
-  Container* Executor::evaluateExpression(AST::Expression* expression) {
+  ExpressionResult Executor::evaluateExpression(AST::Expression* expression) {
     if (Shared::Classes::isInstanceOf<AST::Expression, AST::NullExpression>(expression)) {
       return this->evaluateNullExpression();
     }
@@ -385,39 +419,42 @@ namespace Runtime {
     throw ExpressionException(expression->getPosition(), "Invalid expression");
   }
 
-  Container* Executor::evaluateNullExpression() {
-    NullValue* nullValue = new NullValue();
-    return this->createExpressionEvaluationContainer(nullValue);
+  ExpressionResult Executor::evaluateNullExpression() {
+    TaggedValue nullValue = TaggedValue();
+    return this->createExpressionEvaluationResult(nullValue);
   }
-  Container* Executor::evaluateLiteralExpression(AST::LiteralExpression* expression) {
-    Value* value = nullptr;
+  ExpressionResult Executor::evaluateLiteralExpression(AST::LiteralExpression* expression) {
+    // literal is converted on the first evaluation only
+    if (!expression->getIsMaterialized()) {
+      expression->setRuntimeValue(this->materializeLiteralExpression(expression));
+    }
 
+    return ExpressionResult::fromValue(expression->getRuntimeValue());
+  }
+  TaggedValue Executor::materializeLiteralExpression(AST::LiteralExpression* expression) {
     if (expression->getValue().isOfType(Specification::TokenType::NULL_KEYWORD_TOKEN)) {
-      value = new NullValue();
+      return TaggedValue();
     }
     if (expression->getValue().isOfType(Specification::TokenType::TRUE_KEYWORD_TOKEN)) {
-      value = new BooleanValue(true);
+      return TaggedValue::fromBoolean(true);
     }
     if (expression->getValue().isOfType(Specification::TokenType::FALSE_KEYWORD_TOKEN)) {
-      value = new BooleanValue(false);
+      return TaggedValue::fromBoolean(false);
     }
     if (expression->getValue().isOfType(Specification::TokenType::NUMBER_TOKEN)) {
-      value = new NumberValue(std::stod(expression->getValue().getCode()));
+      return TaggedValue::fromNumber(std::stod(expression->getValue().getCode()));
     }
+    // strings are interned, so literal values are permanent
     if (expression->getValue().isOfType(Specification::TokenType::STRING_TOKEN)) {
-      value = new StringValue(expression->getValue().getCode());
-    }
-
-    if (value == nullptr) {
-      throw TypeException(expression->getPosition(), "Invalid literal expression");
+      return this->memory.internString(expression->getValue().getCode());
     }
 
-    return this->createExpressionEvaluationContainer(value);
+    throw TypeException(expression->getPosition(), "Invalid literal expression");
   }
-  Container* Executor::evaluateIdentifierExpression(AST::IdentifierExpression* expression) {
-    return this->memory.getCurrentStack()->getContainerByName(expression->getName().getCode());
+  ExpressionResult Executor::evaluateIdentifierExpression(AST::IdentifierExpression* expression) {
+    return ExpressionResult::fromContainer(this->memory.getCurrentStack()->getContainerByName(expression->getName().getCode()));
   }
-  Container* Executor::evaluateUnaryExpression(AST::UnaryOperationExpression* expression) {
+  ExpressionResult Executor::evaluateUnaryExpression(AST::UnaryOperationExpression* expression) {
     if (expression->getOperator().isOfType(Specification::TokenType::NOT_TOKEN)) {
       return this->evaluateNotExpression(expression);
     }
@@ -433,107 +470,105 @@ namespace Runtime {
 
     throw ExpressionException(expression->getPosition(), "Invalid unary expression");
   }
-  Container* Executor::evaluateBinaryExpression(AST::BinaryOperationExpression* expression) {
+  ExpressionResult Executor::evaluateBinaryExpression(AST::BinaryOperationExpression* expression) {
+    // quickened sites skip operator dispatch
+    if (expression->getProfile()->getIsQuickened()) {
+      return this->evaluateQuickenedBinaryExpression(expression);
+    }
+
+    // operators with kernels evaluate both operands before dispatch
+    if (expression->getKernelOperator() != KernelOperator::None) {
+      ExpressionResult leftResult = this->evaluateExpression(expression->getLeft());
+      ExpressionResult rightResult = this->evaluateExpression(expression->getRight());
+
+      TaggedValue leftOperand = leftResult.getValue();
+      TaggedValue rightOperand = rightResult.getValue();
+
+      ExpressionResult result = this->evaluateKernelBinaryExpression(expression, leftOperand, rightOperand);
+      this->profileBinaryExpression(expression, leftOperand, rightOperand);
+
+      return result;
+    }
+    if (expression->getAssignKernelOperator() != KernelOperator::None) {
+      return this->evaluateCompoundAssignExpression(expression);
+    }
+
     if (expression->getOperator().isOfType(Specification::TokenType::ASSIGN_TOKEN)) {
       return this->evaluateAssignExpression(expression);
     }
     if (expression->getOperator().isOfType(Specification::TokenType::DOT_TOKEN)) {
       return this->evaluateMemberAccessExpression(expression);
     }
-    if (expression->getOperator().isOfType(Specification::TokenType::PLUS_TOKEN)) {
-      return this->evaluateAdditionExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::MINUS_TOKEN)) {
-      return this->evaluateSubtractionExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::MULTIPLICATION_TOKEN)) {
-      return this->evaluateMultiplicationExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::DIVISION_TOKEN)) {
-      return this->evaluateDivisionExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::EXPONENTIAL_TOKEN)) {
-      return this->evaluateExponentialExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::REMAINDER_TOKEN)) {
-      return this->evaluateRemainderExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::BIT_AND_TOKEN)) {
-      return this->evaluateBitAndExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::BIT_OR_TOKEN)) {
-      return this->evaluateBitOrExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::BIT_XOR_TOKEN)) {
-      return this->evaluateBitXorExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::LEFT_SHIFT_TOKEN)) {
-      return this->evaluateLeftShiftExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::RIGHT_SHIFT_TOKEN)) {
-      return this->evaluateRightShiftExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::PLUS_ASSIGN_TOKEN)) {
-      return this->evaluateAdditionAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::MINUS_ASSIGN_TOKEN)) {
-      return this->evaluateSubtractionAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::MULTIPLICATION_ASSIGN_TOKEN)) {
-      return this->evaluateMultiplicationAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::DIVISION_ASSIGN_TOKEN)) {
-      return this->evaluateDivisionAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::EXPONENTIAL_ASSIGN_TOKEN)) {
-      return this->evaluateExponentialAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::REMAINDER_ASSIGN_TOKEN)) {
-      return this->evaluateRemainderAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::BIT_AND_ASSIGN_TOKEN)) {
-      return this->evaluateBitAndAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::BIT_OR_ASSIGN_TOKEN)) {
-      return this->evaluateBitOrAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::BIT_XOR_ASSIGN_TOKEN)) {
-      return this->evaluateBitXorAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::LEFT_SHIFT_ASSIGN_TOKEN)) {
-      return this->evaluateLeftShiftAssignExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::RIGHT_SHIFT_ASSIGN_TOKEN)) {
-      return this->evaluateRightShiftAssignExpression(expression);
-    }
     if (expression->getOperator().isOfType(Specification::TokenType::AND_TOKEN)) {
       return this->evaluateAndExpression(expression);
     }
     if (expression->getOperator().isOfType(Specification::TokenType::OR_TOKEN)) {
       return this->evaluateOrExpression(expression);
     }
-    if (expression->getOperator().isOfType(Specification::TokenType::EQUAL_TOKEN)) {
-      return this->evaluateEqualExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::NOT_EQUAL_TOKEN)) {
-      return this->evaluateNotEqualExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::GREATER_THAN_TOKEN)) {
-      return this->evaluateGreaterThanExpression(expression);
-    }
-    if (expression->getOperator().isOfType(Specification::TokenType::LESS_THAN_TOKEN)) {
-      return this->evaluateLessThanExpression(expression);
+
+    throw ExpressionException(expression->getPosition(), "Invalid binary expression");
+  }
+  ExpressionResult Executor::evaluateKernelBinaryExpression(AST::BinaryOperationExpression* expression, TaggedValue leftOperand, TaggedValue rightOperand) {
+    BinaryKernel kernel = getBinaryKernel(expression->getKernelOperator(), leftOperand.getType(), rightOperand.getType());
+
+    if (kernel == NULL) {
+      throw TypeException(expression->getPosition(), "Operator \"" + expression->getOperator().getCode() + "\" is used with invalid type pair");
     }
-    if (expression->getOperator().isOfType(Specification::TokenType::GREATER_THAN_OR_EQUAL_TOKEN)) {
-      return this->evaluateGreaterThanOrEqualExpression(expression);
+
+    return this->createExpressionEvaluationResult(kernel(this->memory, leftOperand, rightOperand));
+  }
+  ExpressionResult Executor::evaluateQuickenedBinaryExpression(AST::BinaryOperationExpression* expression) {
+    ExpressionResult leftResult = this->evaluateExpression(expression->getLeft());
+    ExpressionResult rightResult = this->evaluateExpression(expression->getRight());
+
+    TaggedValue leftOperand = leftResult.getValue();
+    TaggedValue rightOperand = rightResult.getValue();
+
+    OperationProfile* profile = expression->getProfile();
+
+    // common number operators are computed inline, numbers need no temporaries
+    if (leftOperand.isNumber() && rightOperand.isNumber()) {
+      double leftValue = leftOperand.getNumber();
+      double rightValue = rightOperand.getNumber();
+
+      switch (profile->getNumberOperator()) {
+        case KernelOperator::Addition: return ExpressionResult::fromValue(TaggedValue::fromNumber(leftValue + rightValue));
+        case KernelOperator::Subtraction: return ExpressionResult::fromValue(TaggedValue::fromNumber(leftValue - rightValue));
+        case KernelOperator::Multiplication: return ExpressionResult::fromValue(TaggedValue::fromNumber(leftValue * rightValue));
+        case KernelOperator::Division: return ExpressionResult::fromValue(TaggedValue::fromNumber(leftValue / rightValue));
+
+        case KernelOperator::Equal: return ExpressionResult::fromValue(TaggedValue::fromBoolean(leftValue == rightValue));
+        case KernelOperator::NotEqual: return ExpressionResult::fromValue(TaggedValue::fromBoolean(leftValue != rightValue));
+        case KernelOperator::GreaterThan: return ExpressionResult::fromValue(TaggedValue::fromBoolean(leftValue > rightValue));
+        case KernelOperator::LessThan: return ExpressionResult::fromValue(TaggedValue::fromBoolean(leftValue < rightValue));
+        case KernelOperator::GreaterThanOrEqual: return ExpressionResult::fromValue(TaggedValue::fromBoolean(leftValue >= rightValue));
+        case KernelOperator::LessThanOrEqual: return ExpressionResult::fromValue(TaggedValue::fromBoolean(leftValue <= rightValue));
+
+        // other operators use the kernel
+        default: break;
+      }
     }
-    if (expression->getOperator().isOfType(Specification::TokenType::LESS_THAN_OR_EQUAL_TOKEN)) {
-      return this->evaluateLessThanOrEqualExpression(expression);
+
+    // cached kernel is valid only for the profiled operand types
+    if (leftOperand.getType() == profile->getLeftType() && rightOperand.getType() == profile->getRightType()) {
+      return this->createExpressionEvaluationResult(profile->getKernel()(this->memory, leftOperand, rightOperand));
     }
 
-    throw ExpressionException(expression->getPosition(), "Invalid binary expression");
+    // operand types differ from the profiled ones, site falls back to generic path
+    profile->dequicken();
+    return this->evaluateKernelBinaryExpression(expression, leftOperand, rightOperand);
   }
-  Container* Executor::evaluateGroupingExpression(AST::GroupingExpression* expression) {
+  void Executor::profileBinaryExpression(AST::BinaryOperationExpression* expression, TaggedValue leftOperand, TaggedValue rightOperand) {
+    OperationProfile* profile = expression->getProfile();
+    if (profile->getIsGeneric()) return;
+
+    // site is quickened after the same operand types are seen several times in a row
+    if (!profile->record(leftOperand.getType(), rightOperand.getType())) return;
+
+    KernelOperator operation = expression->getKernelOperator();
+    profile->quicken(operation, getBinaryKernel(operation, profile->getLeftType(), profile->getRightType()));
+  }
+  ExpressionResult Executor::evaluateGroupingExpression(AST::GroupingExpression* expression) {
     if (expression->getOperator().isOfType(Specification::TokenType::LEFT_PARENTHESES_TOKEN)) {
       return this->evaluateParenthesesExpression(expression);
     }
@@ -543,7 +578,7 @@ namespace Runtime {
 
     throw ExpressionException(expression->getPosition(), "Invalid grouping expression");
   }
-  Container* Executor::evaluateGroupingApplicationExpression(AST::GroupingApplicationExpression* expression) {
+  ExpressionResult Executor::evaluateGroupingApplicationExpression(AST::GroupingApplicationExpression* expression) {
     if (expression->getRight()->getOperator().isOfType(Specification::TokenType::LEFT_PARENTHESES_TOKEN)) {
       return this->evaluateParenthesesApplicationExpression(expression);
     }
@@ -553,618 +588,401 @@ namespace Runtime {
 
     throw ExpressionException(expression->getRight()->getOperator().getPosition(), "Invalid grouping application expression");
   }
-  Container* Executor::evaluateAssociationExpression(AST::AssociationExpression* expression) {
-    throw Exception("Not implemented");
-  }
-
-  // special expression types
-  Container* Executor::evaluateAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-    this->handleContainerValueReassignment(leftContainer, rightContainer->getValue());
-
-    return leftContainer;
-  }
-  Container* Executor::evaluateMemberAccessExpression(AST::BinaryOperationExpression* expression) {
-    Container* structure = this->evaluateExpression(expression->getLeft());
-    Container* member = this->evaluateExpression(expression->getRight());
-
-    Value* structureValue = structure->getValue();
-    Value* memberValue = member->getValue();
+  ExpressionResult Executor::evaluateAssociationExpression(AST::AssociationExpression* expression) {
+    const std::vector<std::pair<AST::Expression*, AST::Expression*>>& entries = expression->getEntries();
+    LiteralShapeCache* cache = expression->getShapeCache();
 
-    Container* result = NULL;
-
-    // choose search type
-    if (Shared::Classes::isInstanceOf<Value, ClassValue>(structureValue)) {
-      result = this->evaluateStaticMemberAccessExpression(Shared::Classes::cast<Value, ClassValue>(structureValue), memberValue);
-    } else {
-      result = this->evaluateInstanceMemberAccessExpression(structureValue, memberValue);
+    if (!cache->getIsResolved() && this->hasConstantAssociationKeys(expression)) {
+      this->resolveAssociationShape(expression);
     }
 
-    // if result is found - return it
-    if (result != NULL) return result;
-    
-    throw ExpressionException(expression->getPosition(), "Member cannot be resolved");
-  }
-  Container* Executor::evaluateStaticMemberAccessExpression(ClassValue* structure, Value* member) {
-    // get fields
-    std::vector<Field> fields = structure->getFields();
-
-    // check class fields (static fields)
-    // all the static fields are put to fields list
-    // values of static fields are the pointers for base class fields (same values)
-    for (int i = 0; i < fields.size(); i++) {
-      // only static fields can be accessed through class name
-      if (fields[i].getType() != FieldType::STATIC) continue;
+    // object of resolved site gets the final shape at once, values are written by slots
+    if (cache->getIsResolved() && !cache->getIsDictionary()) {
+      ObjectValue* object = new ObjectValue(NULL, cache->getShape(), std::vector<TaggedValue>(cache->getShape()->getSlotsAmount()));
 
-      // check the member identifier
-      if (!compareValues(fields[i].getKey(), member)) continue;
+      for (int i = 0; i < entries.size(); i++) {
+        TaggedValue value = this->memory.retainValue(this->evaluateExpression(entries[i].second).getValue());
+        int slot = cache->getSlots()[i];
 
-      // private can be used only if the current context is a class
-      if (fields[i].getAccess() == FieldAccess::PRIVATE && !compareValues(fields[i].getClassOwner(), this->currentContextClass)) continue;
-      // protected can be used only if the current context is a super class of a class
-      if (fields[i].getAccess() == FieldAccess::PROTECTED && !isInstanceOf(fields[i].getClassOwner(), this->currentContextClass)) continue;
+        // repeated key overrides the previous value
+        this->memory.releaseValue(object->getValue(slot));
+        object->setValue(slot, value);
+      }
 
-      // if all the filters are passed 
-      Container* result = this->createTemporaryConstantContainer(fields[i].getValue());
-      return result;
+      return this->createExpressionEvaluationResult(TaggedValue::fromPointer(object));
     }
 
-    // TODO: check prototype
+    // computed keys and large literals add entries one by one
+    ObjectValue* object = new ObjectValue(NULL, this->memory.getRootShape(), {});
+    if (cache->getIsDictionary()) object->convertToDictionary();
 
-    return NULL;
-  }
-  Container* Executor::evaluateInstanceMemberAccessExpression(Value* structure, Value* member) {
-    // check if a structure is object
-    if (Shared::Classes::isInstanceOf<Value, ObjectValue>(structure)) {
-      ObjectValue* castedValue = Shared::Classes::cast<Value, ObjectValue>(structure);
-      std::vector<Field> entries = castedValue->getEntries();
+    for (int i = 0; i < entries.size(); i++) {
+      TaggedValue key = this->evaluateAssociationKey(entries[i].first);
+      // computed key is owned by the object, it is retained before the value can reassign its source
+      if (!isShapeKey(key)) key = this->memory.retainValue(key);
 
-      for (int i = 0; i < entries.size(); i++) {
-        // check the member identifier
-        if (!compareValues(entries[i].getKey(), member)) continue;
+      TaggedValue value = this->memory.retainValue(this->evaluateExpression(entries[i].second).getValue());
 
-        // private fields can be accessed only if the context is a constructor class
-        if (entries[i].getAccess() == FieldAccess::PRIVATE && !compareValues(entries[i].getClassOwner(), this->currentContextClass)) continue;
-        // protected fields can be accessed only if the context is super class of constructor
-        if (entries[i].getAccess() == FieldAccess::PROTECTED && !isInstanceOf(entries[i].getClassOwner(), this->currentContextClass)) continue;
+      int slot = object->findSlot(key);
+      if (slot != SHAPE_SLOT_NOT_FOUND) {
+        this->memory.releaseValue(object->getValue(slot));
+        object->setValue(slot, value);
 
-        // if all the filters are passed 
-        Container* result = this->createTemporaryConstantContainer(entries[i].getValue());
-        return result;
+        // existing entry keeps its own key
+        if (!isShapeKey(key)) {
+          this->memory.addTemporaryValue(key);
+          this->memory.releaseValue(key);
+        }
+        continue;
       }
-    }
-
-    // otherwise the field is only in prototype
-    // TODO: check prototype
-
-    return NULL;
-  }
-  Container* Executor::evaluatePrototypeMemberAccessExpression(Value* prototype, Value* member) {
-    throw Exception("Not implemented");
-  }
-
-  // unary expression
-  Container* Executor::evaluateNotExpression(AST::UnaryOperationExpression* expression) {
-    Container* originalExpression = this->evaluateExpression(expression->getOperand());
-    
-    BooleanValue* complementedValue = new BooleanValue(!getBoolean(originalExpression->getValue()));
-    return this->createExpressionEvaluationContainer(complementedValue);
-  }
-  Container* Executor::evaluateBitNotExpression(AST::UnaryOperationExpression* expression) {
-    Container* operandContainer = this->evaluateExpression(expression->getOperand());
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(operandContainer->getValue())) {
-      long long operandValue = NumberValue::getDataOf(operandContainer->getValue());
-
-      Value* result = new NumberValue(~operandValue);
-      return this->createExpressionEvaluationContainer(result);
+      object->addField(FieldDescriptor(FieldAccess::PUBLIC, FieldType::INSTANCE, FieldMutability::VARIABLE, NULL, key), value);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"~\" is used with invalid type");
+    return this->createExpressionEvaluationResult(TaggedValue::fromPointer(object));
   }
-  Container* Executor::evaluateIncrementExpression(AST::UnaryOperationExpression* expression) {
-    Container* operandContainer = this->evaluateExpression(expression->getOperand());
-    if (operandContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(operandContainer->getValue())) {
-      double operandValue = NumberValue::getDataOf(operandContainer->getValue());
-
-      Value* result = new NumberValue(operandValue + 1);
-      this->handleContainerValueReassignment(operandContainer, result);
-
-      return operandContainer;
+  TaggedValue Executor::evaluateAssociationKey(AST::Expression* expression) {
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::IdentifierExpression>(expression)) {
+      AST::IdentifierExpression* name = Shared::Classes::cast<AST::Expression, AST::IdentifierExpression>(expression);
+      return this->memory.internString(name->getName().getCode());
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"++\" is used with invalid type");
+    // literal keys are interned, computed keys are not (they would stay in memory forever)
+    return this->evaluateExpression(expression).getValue();
   }
-  Container* Executor::evaluateDecrementExpression(AST::UnaryOperationExpression* expression) {
-    Container* operandContainer = this->evaluateExpression(expression->getOperand());
-    if (operandContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
+  bool Executor::hasConstantAssociationKeys(AST::AssociationExpression* expression) {
+    const std::vector<std::pair<AST::Expression*, AST::Expression*>>& entries = expression->getEntries();
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(operandContainer->getValue())) {
-      double operandValue = NumberValue::getDataOf(operandContainer->getValue());
+    for (int i = 0; i < entries.size(); i++) {
+      if (Shared::Classes::isInstanceOf<AST::Expression, AST::IdentifierExpression>(entries[i].first)) continue;
+      if (Shared::Classes::isInstanceOf<AST::Expression, AST::LiteralExpression>(entries[i].first)) continue;
 
-      Value* result = new NumberValue(operandValue - 1);
-      this->handleContainerValueReassignment(operandContainer, result);
-
-      return operandContainer;
+      return false;
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"--\" is used with invalid type");
+    return true;
   }
+  void Executor::resolveAssociationShape(AST::AssociationExpression* expression) {
+    const std::vector<std::pair<AST::Expression*, AST::Expression*>>& entries = expression->getEntries();
 
-  // binary expressions
-  Container* Executor::evaluateAdditionExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    // number + number
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      double rightValue = NumberValue::getDataOf(rightContainer->getValue());
-
-      NumberValue* result = new NumberValue(leftValue + rightValue);
-      return this->createExpressionEvaluationContainer(result);
+    // large literal is not put to shapes tree, its objects are dictionaries
+    if (entries.size() > OBJECT_DICTIONARY_THRESHOLD) {
+      expression->getShapeCache()->resolve(NULL, {}, true);
+      return;
     }
 
-    // string + string
-    if (Shared::Classes::isInstanceOf<Value, StringValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, StringValue>(rightContainer->getValue())) {
-      std::string leftValue = StringValue::getDataOf(leftContainer->getValue());
-      std::string rightValue = StringValue::getDataOf(rightContainer->getValue());
-
-      StringValue* result = new StringValue(leftValue + rightValue);
-      return this->createExpressionEvaluationContainer(result);
-    }
+    Shape* shape = this->memory.getRootShape();
+    std::vector<int> slots = {};
 
-    throw TypeException(expression->getPosition(), "Operator \"+\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateSubtractionExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+    for (int i = 0; i < entries.size(); i++) {
+      TaggedValue key = this->evaluateAssociationKey(entries[i].first);
 
-    // number - number
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      double rightValue = NumberValue::getDataOf(rightContainer->getValue());
+      int slot = shape->findSlot(key);
+      if (slot == SHAPE_SLOT_NOT_FOUND) {
+        shape = shape->addTransition(FieldDescriptor(FieldAccess::PUBLIC, FieldType::INSTANCE, FieldMutability::VARIABLE, NULL, key));
+        slot = shape->getSlotsAmount() - 1;
+      }
 
-      NumberValue* result = new NumberValue(leftValue - rightValue);
-      return this->createExpressionEvaluationContainer(result);
+      slots.push_back(slot);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"-\" is used with invalid type pair");
+    expression->getShapeCache()->resolve(shape, slots, false);
   }
-  Container* Executor::evaluateMultiplicationExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    // number * number
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      double rightValue = NumberValue::getDataOf(rightContainer->getValue());
 
-      NumberValue* result = new NumberValue(leftValue * rightValue);
-      return this->createExpressionEvaluationContainer(result);
-    }
-
-    throw TypeException(expression->getPosition(), "Operator \"*\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateDivisionExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+  // special expression types
+  ExpressionResult Executor::evaluateAssignExpression(AST::BinaryOperationExpression* expression) {
+    if (this->isIndexExpression(expression->getLeft())) return this->evaluateIndexAssignExpression(expression);
 
-    // number / number
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      double rightValue = NumberValue::getDataOf(rightContainer->getValue());
+    Container* leftContainer = this->getAssignedContainer(this->evaluateExpression(expression->getLeft()), expression);
 
-      NumberValue* result = new NumberValue(leftValue / rightValue);
-      return this->createExpressionEvaluationContainer(result);
-    }
+    ExpressionResult rightResult = this->evaluateExpression(expression->getRight());
+    this->handleContainerValueReassignment(leftContainer, rightResult.getValue());
 
-    throw TypeException(expression->getPosition(), "Operator \"/\" is used with invalid type pair");
+    return ExpressionResult::fromContainer(leftContainer);
   }
-  Container* Executor::evaluateExponentialExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+  ExpressionResult Executor::evaluateCompoundAssignExpression(AST::BinaryOperationExpression* expression) {
+    if (this->isIndexExpression(expression->getLeft())) return this->evaluateIndexAssignExpression(expression);
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      double rightValue = NumberValue::getDataOf(rightContainer->getValue());
+    Container* leftContainer = this->getAssignedContainer(this->evaluateExpression(expression->getLeft()), expression);
 
-      NumberValue* result = new NumberValue(std::pow(leftValue, rightValue));
-      return this->createExpressionEvaluationContainer(result);
-    }
+    ExpressionResult rightResult = this->evaluateExpression(expression->getRight());
 
-    throw TypeException(expression->getPosition(), "Operator \"**\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateRemainderExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+    TaggedValue leftOperand = leftContainer->getValue();
+    TaggedValue rightOperand = rightResult.getValue();
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long leftValue = (long long)NumberValue::getDataOf(leftContainer->getValue());
-      long long rightValue = (long long)NumberValue::getDataOf(rightContainer->getValue());
+    // string owned only by the container is extended in place
+    bool isConcatenation = expression->getAssignKernelOperator() == KernelOperator::Addition && leftOperand.isPointer() && rightOperand.isPointer();
+    if (isConcatenation && leftOperand.getType() == DataType::String && rightOperand.getType() == DataType::String && this->memory.isUniquelyReferenced(leftOperand)) {
+      StringValue* left = Shared::Classes::cast<Value, StringValue>(leftOperand.getPointer());
+      StringValue* right = Shared::Classes::cast<Value, StringValue>(rightOperand.getPointer());
 
-      NumberValue* result = new NumberValue(leftValue % rightValue);
-      return this->createExpressionEvaluationContainer(result);
+      left->append(right);
+      return ExpressionResult::fromContainer(leftContainer);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"%\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateBitAndExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      long long rightValue = NumberValue::getDataOf(rightContainer->getValue());
+    BinaryKernel kernel = getBinaryKernel(expression->getAssignKernelOperator(), leftOperand.getType(), rightOperand.getType());
 
-      NumberValue* result = new NumberValue(leftValue & rightValue);
-      return this->createExpressionEvaluationContainer(result);
+    if (kernel == NULL) {
+      throw TypeException(expression->getPosition(), "Operator \"" + expression->getOperator().getCode() + "\" is used with invalid type pair");
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"&\" is used with invalid type pair");
+    this->handleContainerValueReassignment(leftContainer, kernel(this->memory, leftOperand, rightOperand));
+    return ExpressionResult::fromContainer(leftContainer);
   }
-  Container* Executor::evaluateBitOrExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+  ExpressionResult Executor::evaluateIndexAssignExpression(AST::BinaryOperationExpression* expression) {
+    AST::GroupingApplicationExpression* target = Shared::Classes::cast<AST::Expression, AST::GroupingApplicationExpression>(expression->getLeft());
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      long long rightValue = NumberValue::getDataOf(rightContainer->getValue());
+    VectorValue* vector = this->getIndexedVector(this->evaluateExpression(target->getLeft()).getValue(), target);
+    TaggedValue index = this->evaluateIndexExpression(target);
 
-      NumberValue* result = new NumberValue(leftValue | rightValue);
-      return this->createExpressionEvaluationContainer(result);
-    }
-
-    throw TypeException(expression->getPosition(), "Operator \"|\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateBitXorExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+    // right side can reassign the container of vector, so the vector is retained while it runs
+    TaggedValue structure = this->memory.retainValue(TaggedValue::fromPointer(vector));
+    TaggedValue value;
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      long long rightValue = NumberValue::getDataOf(rightContainer->getValue());
-
-      NumberValue* result = new NumberValue(leftValue ^ rightValue);
-      return this->createExpressionEvaluationContainer(result);
+    try {
+      value = this->storeVectorItem(expression, target, vector, index);
     }
-
-    throw TypeException(expression->getPosition(), "Operator \"^\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateLeftShiftExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      long long rightValue = NumberValue::getDataOf(rightContainer->getValue());
-
-      NumberValue* result = new NumberValue(leftValue << rightValue);
-      return this->createExpressionEvaluationContainer(result);
+    catch (...) {
+      this->memory.releaseValue(structure);
+      throw;
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"<<\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateRightShiftExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long leftValue = NumberValue::getDataOf(leftContainer->getValue());
-      long long rightValue = NumberValue::getDataOf(rightContainer->getValue());
-
-      NumberValue* result = new NumberValue(leftValue >> rightValue);
-      return this->createExpressionEvaluationContainer(result);
-    }
+    // vector lives until temporaries are cleared, so the stored value stays valid if it was the last reference
+    this->memory.addTemporaryValue(structure);
+    this->memory.releaseValue(structure);
 
-    throw TypeException(expression->getPosition(), "Operator \">>\" is used with invalid type pair");
+    return ExpressionResult::fromValue(value);
   }
-  Container* Executor::evaluateAdditionAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
+  TaggedValue Executor::storeVectorItem(AST::BinaryOperationExpression* expression, AST::GroupingApplicationExpression* target, VectorValue* vector, TaggedValue index) {
+    TaggedValue value = this->evaluateExpression(expression->getRight()).getValue();
 
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+    // right side can change the size of vector, so index is validated after it
+    int position = this->getVectorIndex(vector, index, target);
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
+    // compound assignment applies kernel to the current item
+    if (expression->getAssignKernelOperator() != KernelOperator::None) {
+      TaggedValue item = vector->getItem(position);
+      BinaryKernel kernel = getBinaryKernel(expression->getAssignKernelOperator(), item.getType(), value.getType());
 
-      Value* result = new NumberValue(left + right);
-      this->handleContainerValueReassignment(leftContainer, result);
+      if (kernel == NULL) {
+        throw TypeException(expression->getPosition(), "Operator \"" + expression->getOperator().getCode() + "\" is used with invalid type pair");
+      }
 
-      return leftContainer;
+      value = kernel(this->memory, item, value);
     }
-    if (Shared::Classes::isInstanceOf<Value, StringValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, StringValue>(rightContainer->getValue())) {
-      std::string left = StringValue::getDataOf(leftContainer->getValue());
-      std::string right = StringValue::getDataOf(rightContainer->getValue());
-
-      Value* result = new StringValue(left + right);
-      this->handleContainerValueReassignment(leftContainer, result);
 
-      return leftContainer;
-    }
+    // numbers are stored in place, other items are retained by the vector
+    TaggedValue previous = vector->getItem(position);
+    value = this->memory.retainValue(value);
+    vector->setItem(position, value);
+    this->memory.releaseValue(previous);
 
-    throw TypeException(expression->getPosition(), "Operator \"+=\" is used with invalid type pair");
+    return value;
   }
-  Container* Executor::evaluateSubtractionAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
-
-      Value* result = new NumberValue(left - right);
-      this->handleContainerValueReassignment(leftContainer, result);
+  ExpressionResult Executor::evaluateMemberAccessExpression(AST::BinaryOperationExpression* expression) {
+    ExpressionResult structure = this->evaluateExpression(expression->getLeft());
+    TaggedValue structureValue = structure.getValue();
 
-      return leftContainer;
+    // member names are interned keys, so they are compared with field keys by pointer
+    // only sites with constant member name are cached
+    TaggedValue memberValue;
+    MemberCache* cache = NULL;
+    if (Shared::Classes::isInstanceOf<AST::Expression, AST::IdentifierExpression>(expression->getRight())) {
+      AST::IdentifierExpression* memberName = Shared::Classes::cast<AST::Expression, AST::IdentifierExpression>(expression->getRight());
+      memberValue = this->memory.internString(memberName->getName().getCode());
+      cache = expression->getMemberCache();
+    } else {
+      memberValue = this->evaluateExpression(expression->getRight()).getValue();
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"-=\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateMultiplicationAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+    std::optional<ExpressionResult> result;
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
-
-      Value* result = new NumberValue(left * right);
-      this->handleContainerValueReassignment(leftContainer, result);
-
-      return leftContainer;
+    // choose search type
+    if (structureValue.getType() == DataType::Class) {
+      result = this->evaluateStaticMemberAccessExpression(Shared::Classes::cast<Value, ClassValue>(structureValue.getPointer()), memberValue, cache);
+    } else {
+      result = this->evaluateInstanceMemberAccessExpression(structureValue, memberValue, cache);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"*=\" is used with invalid type pair");
+    // if result is found - return it
+    if (result.has_value()) return result.value();
+    
+    throw ExpressionException(expression->getPosition(), "Member cannot be resolved");
   }
-  Container* Executor::evaluateDivisionAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
+  std::optional<ExpressionResult> Executor::evaluateStaticMemberAccessExpression(ClassValue* structure, TaggedValue member, MemberCache* cache) {
+    // get fields
+    const std::vector<Field>& fields = structure->getFields();
 
-      Value* result = new NumberValue(left / right);
-      this->handleContainerValueReassignment(leftContainer, result);
+    // cached slot has passed the filters for this class and context
+    // fields of a class are not changed after declaration, so the slot needs no guard
+    if (cache) {
+      int slot = cache->lookup(DataType::Class, structure, structure->getIdentity(), this->getContextIdentity());
+      if (slot != MEMBER_CACHE_MISS) return ExpressionResult::fromValue(fields[slot].getValue());
+    }
 
-      return leftContainer;
+    int slot = this->findStaticMemberSlot(structure, member);
+    if (slot == MEMBER_CACHE_MISS) {
+      // TODO: check prototype
+      return std::nullopt;
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"/=\" is used with invalid type pair");
+    if (cache) cache->record(DataType::Class, structure, structure->getIdentity(), this->getContextIdentity(), slot);
+
+    // field values are held by the class
+    return ExpressionResult::fromValue(fields[slot].getValue());
   }
-  Container* Executor::evaluateExponentialAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
+  std::optional<ExpressionResult> Executor::evaluateInstanceMemberAccessExpression(TaggedValue structure, TaggedValue member, MemberCache* cache) {
+    // check if a structure is object
+    if (structure.getType() == DataType::Object) {
+      ObjectValue* castedValue = Shared::Classes::cast<Value, ObjectValue>(structure.getPointer());
 
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+      // shape holds keys and access of all the entries, so the cached slot needs no guard
+      // dictionary objects do not share layout and are looked up by their tables
+      Shape* shape = castedValue->getShape();
+      if (castedValue->getIsDictionary()) cache = NULL;
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
+      if (cache) {
+        int slot = cache->lookup(DataType::Object, shape, 0, this->getContextIdentity());
+        if (slot != MEMBER_CACHE_MISS) return ExpressionResult::fromValue(castedValue->getValue(slot));
+      }
 
-      Value* result = new NumberValue(std::pow(left, right));
-      this->handleContainerValueReassignment(leftContainer, result);
+      int slot = this->findInstanceMemberSlot(castedValue, member);
+      if (slot != MEMBER_CACHE_MISS) {
+        if (cache) cache->record(DataType::Object, shape, 0, this->getContextIdentity(), slot);
 
-      return leftContainer;
+        // entry values are held by the object
+        return ExpressionResult::fromValue(castedValue->getValue(slot));
+      }
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"**=\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateRemainderAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long left = NumberValue::getDataOf(leftContainer->getValue());
-      long long right = NumberValue::getDataOf(rightContainer->getValue());
-
-      Value* result = new NumberValue(left % right);
-      this->handleContainerValueReassignment(leftContainer, result);
-
-      return leftContainer;
+    // otherwise the field is only in prototype
+    if (structure.getType() == DataType::Object) {
+      ClassValue* constructor = Shared::Classes::cast<Value, ObjectValue>(structure.getPointer())->getConstructor();
+      if (constructor != NULL) return this->evaluatePrototypeMemberAccessExpression(TaggedValue::fromPointer(constructor), member);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"%=\" is used with invalid type pair");
+    return std::nullopt;
   }
-  Container* Executor::evaluateBitAndAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long left = NumberValue::getDataOf(leftContainer->getValue());
-      long long right = NumberValue::getDataOf(rightContainer->getValue());
+  uint64_t Executor::getContextIdentity() {
+    if (this->currentContextClass == NULL) return 0;
+    return this->currentContextClass->getIdentity();
+  }
+  int Executor::findStaticMemberSlot(ClassValue* structure, TaggedValue member) {
+    // only static fields can be accessed through class name
+    // inherited static fields are put to fields list of the class by linearization order
+    int slot = structure->findStaticSlot(member);
+    if (slot == FIELD_SLOT_NOT_FOUND) return MEMBER_CACHE_MISS;
 
-      Value* result = new NumberValue(left & right);
-      this->handleContainerValueReassignment(leftContainer, result);
+    const Field& field = structure->getFields()[slot];
 
-      return leftContainer;
-    }
+    // private can be used only if the current context is a class
+    if (field.getAccess() == FieldAccess::PRIVATE && field.getClassOwner() != this->currentContextClass) return MEMBER_CACHE_MISS;
+    // protected can be used only if the current context is a super class of a class
+    if (field.getAccess() == FieldAccess::PROTECTED && !isInstanceOf(field.getClassOwner(), this->currentContextClass)) return MEMBER_CACHE_MISS;
 
-    throw TypeException(expression->getPosition(), "Operator \"&=\" is used with invalid type pair");
+    // if all the filters are passed 
+    return slot;
   }
-  Container* Executor::evaluateBitOrAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long left = NumberValue::getDataOf(leftContainer->getValue());
-      long long right = NumberValue::getDataOf(rightContainer->getValue());
+  int Executor::findInstanceMemberSlot(ObjectValue* structure, TaggedValue member) {
+    int slot = structure->findSlot(member);
+    if (slot == SHAPE_SLOT_NOT_FOUND) return MEMBER_CACHE_MISS;
 
-      Value* result = new NumberValue(left | right);
-      this->handleContainerValueReassignment(leftContainer, result);
+    const FieldDescriptor& descriptor = structure->getDescriptor(slot);
 
-      return leftContainer;
-    }
+    // private fields can be accessed only if the context is a constructor class
+    if (descriptor.getAccess() == FieldAccess::PRIVATE && descriptor.getClassOwner() != this->currentContextClass) return MEMBER_CACHE_MISS;
+    // protected fields can be accessed only if the context is super class of constructor
+    if (descriptor.getAccess() == FieldAccess::PROTECTED && !isInstanceOf(descriptor.getClassOwner(), this->currentContextClass)) return MEMBER_CACHE_MISS;
 
-    throw TypeException(expression->getPosition(), "Operator \"|=\" is used with invalid type pair");
+    // if all the filters are passed 
+    return slot;
   }
-  Container* Executor::evaluateBitXorAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long left = NumberValue::getDataOf(leftContainer->getValue());
-      long long right = NumberValue::getDataOf(rightContainer->getValue());
+  std::optional<ExpressionResult> Executor::evaluatePrototypeMemberAccessExpression(TaggedValue prototype, TaggedValue member) {
+    ClassValue* structure = Shared::Classes::cast<Value, ClassValue>(prototype.getPointer());
 
-      Value* result = new NumberValue(left ^ right);
-      this->handleContainerValueReassignment(leftContainer, result);
+    // instance members of class (methods) are resolved by flattened table
+    int slot = structure->findInstanceSlot(member);
+    if (slot == FIELD_SLOT_NOT_FOUND) return std::nullopt;
 
-      return leftContainer;
-    }
+    const Field& field = structure->getFields()[slot];
 
-    throw TypeException(expression->getPosition(), "Operator \"^=\" is used with invalid type pair");
-  } 
-  Container* Executor::evaluateLeftShiftAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
+    if (field.getAccess() == FieldAccess::PRIVATE && field.getClassOwner() != this->currentContextClass) return std::nullopt;
+    if (field.getAccess() == FieldAccess::PROTECTED && !isInstanceOf(field.getClassOwner(), this->currentContextClass)) return std::nullopt;
 
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+    return ExpressionResult::fromValue(field.getValue());
+  }
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long left = NumberValue::getDataOf(leftContainer->getValue());
-      long long right = NumberValue::getDataOf(rightContainer->getValue());
+  // unary expression
+  ExpressionResult Executor::evaluateNotExpression(AST::UnaryOperationExpression* expression) {
+    ExpressionResult originalExpression = this->evaluateExpression(expression->getOperand());
+    
+    TaggedValue complementedValue = TaggedValue::fromBoolean(!getBoolean(originalExpression.getValue()));
+    return this->createExpressionEvaluationResult(complementedValue);
+  }
+  ExpressionResult Executor::evaluateBitNotExpression(AST::UnaryOperationExpression* expression) {
+    ExpressionResult operandResult = this->evaluateExpression(expression->getOperand());
 
-      Value* result = new NumberValue(left << right);
-      this->handleContainerValueReassignment(leftContainer, result);
+    if (operandResult.getValue().isNumber()) {
+      long long operandValue = operandResult.getValue().getNumber();
 
-      return leftContainer;
+      TaggedValue result = TaggedValue::fromNumber(~operandValue);
+      return this->createExpressionEvaluationResult(result);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \"<<=\" is used with invalid type pair");
+    throw TypeException(expression->getPosition(), "Operator \"~\" is used with invalid type");
   }
-  Container* Executor::evaluateRightShiftAssignExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (leftContainer->getIsConstant()) throw ExpressionException(expression->getPosition(), "Assignment to constant");
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+  ExpressionResult Executor::evaluateIncrementExpression(AST::UnaryOperationExpression* expression) {
+    Container* operandContainer = this->getAssignedContainer(this->evaluateExpression(expression->getOperand()), expression);
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      long long left = NumberValue::getDataOf(leftContainer->getValue());
-      long long right = NumberValue::getDataOf(rightContainer->getValue());
+    if (operandContainer->getValue().isNumber()) {
+      double operandValue = operandContainer->getValue().getNumber();
 
-      Value* result = new NumberValue(left >> right);
-      this->handleContainerValueReassignment(leftContainer, result);
+      TaggedValue result = TaggedValue::fromNumber(operandValue + 1);
+      this->handleContainerValueReassignment(operandContainer, result);
 
-      return leftContainer;
+      return ExpressionResult::fromContainer(operandContainer);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \">>=\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateAndExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (!getBoolean(leftContainer->getValue())) return leftContainer;
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-    return rightContainer;
-  }
-  Container* Executor::evaluateOrExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    if (getBoolean(leftContainer->getValue())) return leftContainer;
-
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-    return rightContainer;
+    throw TypeException(expression->getPosition(), "Operator \"++\" is used with invalid type");
   }
-  Container* Executor::evaluateEqualExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+  ExpressionResult Executor::evaluateDecrementExpression(AST::UnaryOperationExpression* expression) {
+    Container* operandContainer = this->getAssignedContainer(this->evaluateExpression(expression->getOperand()), expression);
 
-    BooleanValue* result = new BooleanValue(compareValues(leftContainer->getValue(), rightContainer->getValue()));
-    return this->createExpressionEvaluationContainer(result);
-  }
-  Container* Executor::evaluateNotEqualExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+    if (operandContainer->getValue().isNumber()) {
+      double operandValue = operandContainer->getValue().getNumber();
 
-    BooleanValue* result = new BooleanValue(!compareValues(leftContainer->getValue(), rightContainer->getValue()));
-    return this->createExpressionEvaluationContainer(result);
-  }
-  Container* Executor::evaluateGreaterThanExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
+      TaggedValue result = TaggedValue::fromNumber(operandValue - 1);
+      this->handleContainerValueReassignment(operandContainer, result);
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
-      
-      BooleanValue* result = new BooleanValue(left > right);
-      return this->createExpressionEvaluationContainer(result);
+      return ExpressionResult::fromContainer(operandContainer);
     }
 
-    throw TypeException(expression->getPosition(), "Operator \">\" is used with invalid type pair");
+    throw TypeException(expression->getPosition(), "Operator \"--\" is used with invalid type");
   }
-  Container* Executor::evaluateLessThanExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
 
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
-      
-      BooleanValue* result = new BooleanValue(left < right);
-      return this->createExpressionEvaluationContainer(result);
-    }
+  // binary expressions
+  ExpressionResult Executor::evaluateAndExpression(AST::BinaryOperationExpression* expression) {
+    ExpressionResult leftResult = this->evaluateExpression(expression->getLeft());
+    if (!getBoolean(leftResult.getValue())) return leftResult;
 
-    throw TypeException(expression->getPosition(), "Operator \"<\" is used with invalid type pair");
+    ExpressionResult rightResult = this->evaluateExpression(expression->getRight());
+    return rightResult;
   }
-  Container* Executor::evaluateGreaterThanOrEqualExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
-      
-      BooleanValue* result = new BooleanValue(left >= right);
-      return this->createExpressionEvaluationContainer(result);
-    }
+  ExpressionResult Executor::evaluateOrExpression(AST::BinaryOperationExpression* expression) {
+    ExpressionResult leftResult = this->evaluateExpression(expression->getLeft());
+    if (getBoolean(leftResult.getValue())) return leftResult;
 
-    throw TypeException(expression->getPosition(), "Operator \">=\" is used with invalid type pair");
-  }
-  Container* Executor::evaluateLessThanOrEqualExpression(AST::BinaryOperationExpression* expression) {
-    Container* leftContainer = this->evaluateExpression(expression->getLeft());
-    Container* rightContainer = this->evaluateExpression(expression->getRight());
-
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(leftContainer->getValue()) && Shared::Classes::isInstanceOf<Value, NumberValue>(rightContainer->getValue())) {
-      double left = NumberValue::getDataOf(leftContainer->getValue());
-      double right = NumberValue::getDataOf(rightContainer->getValue());
-      
-      BooleanValue* result = new BooleanValue(left <= right);
-      return this->createExpressionEvaluationContainer(result);
-    }
-
-    throw TypeException(expression->getPosition(), "Operator \"<=\" is used with invalid type pair");
+    ExpressionResult rightResult = this->evaluateExpression(expression->getRight());
+    return rightResult;
   }
 
   // grouping expressions
-  Container* Executor::evaluateParenthesesExpression(AST::GroupingExpression* expression) {
+  ExpressionResult Executor::evaluateParenthesesExpression(AST::GroupingExpression* expression) {
     if (!expression->getExpressions().size()) {
-      NullValue* value = new NullValue();
-      return this->createExpressionEvaluationContainer(value);
+      return ExpressionResult();
     }
 
-    Container* result = nullptr;
-    this->memory.addTemporaryContainer(result);
+    ExpressionResult result;
 
     for (int i = 0; i < expression->getExpressions().size(); i++) {
       result = this->evaluateExpression(expression->getExpressions()[i]);
@@ -1172,45 +990,88 @@ namespace Runtime {
 
     return result;
   }
-  Container* Executor::evaluateSquareBracketsExpression(AST::GroupingExpression* expression) {
+  ExpressionResult Executor::evaluateSquareBracketsExpression(AST::GroupingExpression* expression) {
     VectorValue* list = new VectorValue({});
+    list->reserve(expression->getExpressions().size());
 
     for (int i = 0; i < expression->getExpressions().size(); i++) {
-      list->push(this->evaluateExpression(expression->getExpressions()[i])->getValue());
+      TaggedValue item = this->evaluateExpression(expression->getExpressions()[i]).getValue();
+
+      list->push(this->memory.retainValue(item));
     }
 
-    return this->createExpressionEvaluationContainer(list);
+    return this->createExpressionEvaluationResult(TaggedValue::fromPointer(list));
   }
 
   // grouping application expressions
-  Container* Executor::evaluateParenthesesApplicationExpression(AST::GroupingApplicationExpression* expression) {
+  ExpressionResult Executor::evaluateParenthesesApplicationExpression(AST::GroupingApplicationExpression* expression) {
     // validate function type
-    Container* functionContainer = this->evaluateExpression(expression->getLeft());
-    if (!Shared::Classes::isInstanceOf<Value, FunctionValue>(functionContainer->getValue())) {
+    ExpressionResult functionResult = this->evaluateExpression(expression->getLeft());
+    if (functionResult.getValue().getType() != DataType::Function) {
       throw ExpressionException(expression->getPosition(), "Not a function");
     }
-    FunctionValue* functionValue = Shared::Classes::cast<Value, FunctionValue>(functionContainer->getValue());
+    FunctionValue* functionValue = Shared::Classes::cast<Value, FunctionValue>(functionResult.getValue().getPointer());
     
     // get arguments
-    std::vector<AST::Expression*> argumentExpressions = expression->getRight()->getExpressions();
-    std::vector<Value*> arguments = {};
-    
-    for (int i = 0; i < argumentExpressions.size(); i++) {
-      arguments.push_back(this->evaluateExpression(argumentExpressions[i])->getValue());
-    }
+    const std::vector<AST::Expression*>& argumentExpressions = expression->getRight()->getExpressions();
     
     // validate arguments amount
     FunctionArgumentsAmount functionArgumentsAmount = functionValue->getArgumentsAmount();
-    if (arguments.size() < functionArgumentsAmount.getRequiredArgumentsAmount() || arguments.size() > functionArgumentsAmount.getTotalArgumentsAmount()) {
+    if (argumentExpressions.size() < functionArgumentsAmount.getRequiredArgumentsAmount() || argumentExpressions.size() > functionArgumentsAmount.getTotalArgumentsAmount()) {
       throw ExpressionException(expression->getPosition(), "Invalid arguments amount");
     }
 
     // execute function
-    Value* result = functionValue->execute(arguments);
-    return this->createExpressionEvaluationContainer(result);
+    TaggedValue result;
+    if (functionValue->isBuiltin()) {
+      result = this->executeBuiltinFunction(functionValue, argumentExpressions);
+    } else {
+      result = this->executeScriptFunction(functionValue, argumentExpressions);
+    }
+
+    return this->createExpressionEvaluationResult(result);
+  }
+  ExpressionResult Executor::evaluateSquareBracketsApplicationExpression(AST::GroupingApplicationExpression* expression) {
+    VectorValue* vector = this->getIndexedVector(this->evaluateExpression(expression->getLeft()).getValue(), expression);
+    int position = this->getVectorIndex(vector, this->evaluateIndexExpression(expression), expression);
+
+    // items are held by the vector
+    return ExpressionResult::fromValue(vector->getItem(position));
   }
-  Container* Executor::evaluateSquareBracketsApplicationExpression(AST::GroupingApplicationExpression*) {
-    throw Exception("Not implemented");
+  bool Executor::isIndexExpression(AST::Expression* expression) {
+    if (!Shared::Classes::isInstanceOf<AST::Expression, AST::GroupingApplicationExpression>(expression)) return false;
+
+    AST::GroupingApplicationExpression* application = Shared::Classes::cast<AST::Expression, AST::GroupingApplicationExpression>(expression);
+    return application->getRight()->getOperator().isOfType(Specification::TokenType::LEFT_SQUARE_BRACKET_TOKEN);
+  }
+  TaggedValue Executor::evaluateIndexExpression(AST::GroupingApplicationExpression* expression) {
+    const std::vector<AST::Expression*>& indexes = expression->getRight()->getExpressions();
+
+    if (indexes.size() != 1) {
+      throw ExpressionException(expression->getPosition(), "Exactly one index is expected");
+    }
+
+    return this->evaluateExpression(indexes[0]).getValue();
+  }
+  VectorValue* Executor::getIndexedVector(TaggedValue structure, AST::Expression* expression) {
+    if (structure.getType() != DataType::Vector) {
+      throw TypeException(expression->getPosition(), "Only vectors can be indexed");
+    }
+
+    return Shared::Classes::cast<Value, VectorValue>(structure.getPointer());
+  }
+  int Executor::getVectorIndex(VectorValue* vector, TaggedValue index, AST::Expression* expression) {
+    if (!index.isNumber() || index.getNumber() != std::floor(index.getNumber())) {
+      throw TypeException(expression->getPosition(), "Index has to be an integer");
+    }
+
+    // range is checked before conversion, so large numbers are not truncated
+    double position = index.getNumber();
+    if (position < 0 || position >= vector->getSize()) {
+      throw ExpressionException(expression->getPosition(), "Index is out of range");
+    }
+
+    return position;
   }
  
   // builtins
@@ -1225,32 +1086,148 @@ namespace Runtime {
     throw Exception("Invalid builtin statement found");
   }
   Container* Executor::executeBuiltinConstantDeclaration(Builtins::ConstantBuiltinDeclaration* statement) {
+    // builtin values are owned by declarations
+    this->memory.addPermanentValue(statement->getValue());
+
     Container* constantContainer = new Container(statement->getName(), statement->getValue(), true);
     return constantContainer;
   }
   Container* Executor::executeBuiltinFunctionDeclaration(Builtins::FunctionBuiltinDeclaration* statement) {
-    Runtime::Callable callable = [this, statement](std::vector<Value*> arguments) -> Value* {
-      int argumentsLength = arguments.size();
-      Runtime::FunctionArgumentsAmount callableArgumentsAmount = statement->getArgumentsAmount();
+    Stack* functionClosure = new Stack(this->copyCurrentStack());
+    FunctionValue* functionValue = new FunctionValue(functionClosure, NULL, statement->getCallable(), statement->getArgumentsAmount());
+
+    Container* functionContainer = new Container(statement->getName(), TaggedValue::fromPointer(functionValue), true);
+    return functionContainer;
+  }
+
+  // function calls
+  TaggedValue Executor::executeScriptFunction(FunctionValue* function, const std::vector<AST::Expression*>& argumentExpressions) {
+    const std::vector<FunctionParameter>& parameters = function->getParameters();
+
+    // remember stack from where the function was called
+    Stack* callingStack = this->memory.getCurrentStack();
+    Stack* functionStack = function->getClosure();
+
+    // function is kept alive during the call even if arguments or body reassign its containers
+    this->memory.retainValue(TaggedValue::fromPointer(function));
+
+    // methods are executed in the context of their class
+    // TODO: assign "this" value
+    ClassValue* callingContextClass = this->currentContextClass;
+    if (function->getContext() != NULL && Shared::Classes::isInstanceOf<Value, ClassValue>(function->getContext())) {
+      this->currentContextClass = Shared::Classes::cast<Value, ClassValue>(function->getContext());
+    }
+
+    // open function frame
+    // arguments are evaluated in calling stack and written straight to the frame as anonymous containers
+    // so argument expressions cannot resolve parameters even if function stack is the calling stack
+    functionStack->addScope();
+    int frameBase = functionStack->getCurrentScopeBase();
 
-      if (argumentsLength > callableArgumentsAmount.getTotalArgumentsAmount()) {
-        throw Exception("Too much arguments passed");
+    // default return (null)
+    TaggedValue result;
+
+    try {
+      for (int i = 0; i < parameters.size(); i++) {
+        TaggedValue argumentValue;
+
+        // if an argument is passed: use it
+        if (i < argumentExpressions.size()) {
+          argumentValue = this->evaluateExpression(argumentExpressions[i]).getValue();
+        }
+        // otherwise use default one
+        else {
+          argumentValue = this->evaluateExpression(parameters[i].getDefaultValue()).getValue();
+        }
+
+        Container* argumentContainer = new Container("", argumentValue);
+        functionStack->addContainer(argumentContainer);
+        this->memory.retainContainer(argumentContainer);
       }
-      if (argumentsLength < callableArgumentsAmount.getRequiredArgumentsAmount()) {
-        throw Exception("Not enough arguments passed");
+
+      // bind arguments to parameter names
+      for (int i = 0; i < parameters.size(); i++) {
+        functionStack->getContainers()[frameBase + i]->setName(parameters[i].getName());
       }
 
-      Value* result = statement->getCallable()(arguments);
-      this->memory.addTemporaryValue(result);
+      // go to function stack
+      this->memory.setCurrentStack(functionStack);
 
-      return result;
-    };
+      // execute function body
+      try {
+        this->executeStatement(function->getBody());
+      }
+      catch(ReturnSignal returnSignal) {
+        result = returnSignal.getValue();
+      }
+    }
+    catch (...) {
+      this->leaveScriptFunction(function, callingStack, callingContextClass);
+      throw;
+    }
+
+    this->leaveScriptFunction(function, callingStack, callingContextClass);
+    
+    return result;
+  }
+  void Executor::leaveScriptFunction(FunctionValue* function, Stack* callingStack, ClassValue* callingContextClass) {
+    // leave function frame and stack
+    this->memory.setCurrentStack(function->getClosure());
+    this->removeScopeFromCurrentStack();
+    this->memory.setCurrentStack(callingStack);
+    this->currentContextClass = callingContextClass;
+
+    // function lives until temporaries are cleared, so the result stays valid if it was the last reference
+    TaggedValue functionValue = TaggedValue::fromPointer(function);
+    this->memory.addTemporaryValue(functionValue);
+    this->memory.releaseValue(functionValue);
+  }
+  TaggedValue Executor::executeBuiltinFunction(FunctionValue* function, const std::vector<AST::Expression*>& argumentExpressions) {
+    std::vector<TaggedValue> arguments = {};
+    
+    for (int i = 0; i < argumentExpressions.size(); i++) {
+      arguments.push_back(this->evaluateExpression(argumentExpressions[i]).getValue());
+    }
+
+    return function->execute(this->memory, arguments);
+  }
+
+  FunctionValue* Executor::createScriptFunction(const std::vector<AST::FunctionParameterExpression*>& params, AST::BlockStatement* body, Value* context) {
+    // retain all containers
+    const std::vector<Container*>& containersInCurrentStack = this->memory.getCurrentStack()->getContainers();
+    for (int i = 0; i < containersInCurrentStack.size(); i++) {
+      this->memory.retainContainer(containersInCurrentStack[i]);
+    }
 
+    // parse arguments amount
+    int totalArgumentsAmount = 0;
+    int optionalArgumentsAmount = 0;
+    bool isOptionalParamReached = false;
+
+    for (int i = 0; i < params.size(); i++) {
+      if (params[i]->getDefaultValue() != NULL) {
+        isOptionalParamReached = true;
+        optionalArgumentsAmount++;
+      } else if (isOptionalParamReached) {
+        throw ExpressionException(params[i]->getPosition(), "Required argument goes after optional");
+      }
+      
+      totalArgumentsAmount++;
+    }
+
+    // compose function arguments
+    FunctionArgumentsAmount argumentsAmount(totalArgumentsAmount, optionalArgumentsAmount);
+
+    // compose parameters metadata once per declaration
+    std::vector<FunctionParameter> parameters = {};
+    for (int i = 0; i < params.size(); i++) {
+      parameters.push_back(FunctionParameter(params[i]->getName().getCode(), params[i]->getDefaultValue()));
+    }
+    
+    // create closure
     Stack* functionClosure = new Stack(this->copyCurrentStack());
-    FunctionValue* functionValue = new FunctionValue(functionClosure, NULL, callable, statement->getArgumentsAmount());
 
-    Container* functionContainer = new Container(statement->getName(), functionValue, true);
-    return functionContainer;
+    return new FunctionValue(functionClosure, context, body, parameters, argumentsAmount);
   }
 
   // memory management
@@ -1258,32 +1235,44 @@ namespace Runtime {
     return Stack(*this->memory.getCurrentStack());
   }
   void Executor::addScopeInCurrentStack() {
-    this->memory.getCurrentStack()->addScope(Scope());
+    this->memory.getCurrentStack()->addScope();
   }
   void Executor::removeScopeFromCurrentStack() {
-    std::vector<Container*> containers = this->memory.getCurrentStack()->getContainersFromCurrentScope();
+    Stack* stack = this->memory.getCurrentStack();
+    const std::vector<Container*>& containers = stack->getContainers();
     
-    for (int i = 0; i < containers.size(); i++) {
+    // release containers of the current scope slots
+    for (int i = stack->getCurrentScopeBase(); i < containers.size(); i++) {
       this->memory.releaseContainer(containers[i]);
     }
     
-    this->memory.getCurrentStack()->removeScope();
+    stack->removeScope();
   }
   void Executor::addContainerToCurrentStack(Container* container) {
     this->memory.getCurrentStack()->addContainer(container);
     this->memory.retainContainer(container);
   }
-  Container* Executor::createExpressionEvaluationContainer(Value* value) {
+  ExpressionResult Executor::createExpressionEvaluationResult(TaggedValue value) {
+    // computed heap values live until temporaries are cleared
     this->memory.addTemporaryValue(value);
-    return this->createTemporaryConstantContainer(value);
+    return ExpressionResult::fromValue(value);
   }
-  Container* Executor::createTemporaryConstantContainer(Value* value) {
-    Container* container = new Container("", value, true);
-    this->memory.addTemporaryContainer(container);
-    return container;
+  Container* Executor::getAssignedContainer(ExpressionResult result, AST::Expression* expression) {
+    // only named containers can be assigned, rvalues are constant
+    if (!result.isReference() || result.getContainer()->getIsConstant()) {
+      throw ExpressionException(expression->getPosition(), "Assignment to constant");
+    }
+
+    return result.getContainer();
   }
-  void Executor::handleContainerValueReassignment(Container* container, Value* newValue) {
-    this->memory.retainValue(newValue);
+  void Executor::handleContainerValueReassignment(Container* container, TaggedValue newValue) {
+    // immediates are not counted, so the container slot is just overwritten
+    if (!newValue.isPointer() && !container->getValue().isPointer()) {
+      container->setValue(newValue);
+      return;
+    }
+
+    newValue = this->memory.retainValue(newValue);
     this->memory.releaseValue(container->getValue());
     container->setValue(newValue);
   }
@@ -1,12 +1,17 @@
 #pragma once 
 
+#include "runtime/caches.h"
 #include "runtime/memory.h"
+#include "runtime/quickening.h"
+#include "runtime/results.h"
 #include "runtime/stack.h"
 #include "runtime/types.h"
 #include "builtins/builtins.h"
 #include "resolution/loader.h"
 #include "resolution/module.h"
 
+#include <optional>
+
 namespace Runtime {
   // size of stack at the beginning of execution
   // one scope is for builtins and another one is for root block statement
@@ -17,6 +22,8 @@ namespace Runtime {
       Executor();
 
       void loadModulesFromEntrypoint(std::string);
+      // must be set before modules are loaded
+      void setIsConstantFoldingEnabled(bool);
       void registerBuiltins(std::vector<Builtins::BuiltinModuleDeclarations>);
       void execute();
 
@@ -51,90 +58,104 @@ namespace Runtime {
       Container* executeExportingStatement(AST::Statement* statement);
       // OOP statements
       Container* executeClassDeclarationStatement(AST::ClassDeclarationStatement* statement);
-      Container* executeClassMemberDeclarationStatement(AST::ClassMemberDeclarationStatement* statement);
-      Container* executeClassFieldDeclarationStatement(AST::ClassFieldDeclarationStatement* statement);
-      Container* executeClassMethodDeclarationStatement(AST::ClassMethodDeclarationStatement* statement);
+      // members are declared as fields owned by the class
+      Field executeClassMemberDeclarationStatement(AST::ClassMemberDeclarationStatement* statement, ClassValue*);
+      Field executeClassFieldDeclarationStatement(AST::ClassFieldDeclarationStatement* statement, ClassValue*);
+      Field executeClassMethodDeclarationStatement(AST::ClassMethodDeclarationStatement* statement, ClassValue*);
+      Field createClassField(AST::ClassMemberDeclarationStatement* statement, ClassValue*, TaggedValue);
       // expression statement
       void executeExpressionStatement(AST::ExpressionStatement* statement);
 
       // general expression evaluation
-      Container* evaluateExpression(AST::Expression*);
-
-      Container* evaluateNullExpression();
-      Container* evaluateLiteralExpression(AST::LiteralExpression*);
-      Container* evaluateIdentifierExpression(AST::IdentifierExpression*);
-      Container* evaluateUnaryExpression(AST::UnaryOperationExpression*);
-      Container* evaluateBinaryExpression(AST::BinaryOperationExpression*);
-      Container* evaluateGroupingExpression(AST::GroupingExpression*);
-      Container* evaluateGroupingApplicationExpression(AST::GroupingApplicationExpression*);
-      Container* evaluateAssociationExpression(AST::AssociationExpression*);
+      ExpressionResult evaluateExpression(AST::Expression*);
+
+      ExpressionResult evaluateNullExpression();
+      ExpressionResult evaluateLiteralExpression(AST::LiteralExpression*);
+      // converts literal token to permanent runtime value
+      TaggedValue materializeLiteralExpression(AST::LiteralExpression*);
+      ExpressionResult evaluateIdentifierExpression(AST::IdentifierExpression*);
+      ExpressionResult evaluateUnaryExpression(AST::UnaryOperationExpression*);
+      ExpressionResult evaluateBinaryExpression(AST::BinaryOperationExpression*);
+      // operators with kernels, dispatched by kernels table
+      ExpressionResult evaluateKernelBinaryExpression(AST::BinaryOperationExpression*, TaggedValue, TaggedValue);
+      // specialized variant of operation site with type guard
+      ExpressionResult evaluateQuickenedBinaryExpression(AST::BinaryOperationExpression*);
+      // records operand types and quickens monomorphic sites
+      void profileBinaryExpression(AST::BinaryOperationExpression*, TaggedValue, TaggedValue);
+      ExpressionResult evaluateGroupingExpression(AST::GroupingExpression*);
+      ExpressionResult evaluateGroupingApplicationExpression(AST::GroupingApplicationExpression*);
+      ExpressionResult evaluateAssociationExpression(AST::AssociationExpression*);
+      // identifiers are key names, other keys are evaluated (only names and literals are interned)
+      TaggedValue evaluateAssociationKey(AST::Expression*);
+      // layout of literal is resolved once if all its keys are names or literals
+      bool hasConstantAssociationKeys(AST::AssociationExpression*);
+      void resolveAssociationShape(AST::AssociationExpression*);
 
       // special expression types
-      Container* evaluateAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateMemberAccessExpression(AST::BinaryOperationExpression*);
-      Container* evaluateStaticMemberAccessExpression(ClassValue*, Value*);
-      Container* evaluateInstanceMemberAccessExpression(Value*, Value*);
-      Container* evaluatePrototypeMemberAccessExpression(Value*, Value*);
+      ExpressionResult evaluateAssignExpression(AST::BinaryOperationExpression*);
+      ExpressionResult evaluateCompoundAssignExpression(AST::BinaryOperationExpression*);
+      // assigns item of vector (plain and compound assignment)
+      ExpressionResult evaluateIndexAssignExpression(AST::BinaryOperationExpression*);
+      // evaluates right side and stores it to the vector, returns stored value
+      TaggedValue storeVectorItem(AST::BinaryOperationExpression*, AST::GroupingApplicationExpression*, VectorValue*, TaggedValue);
+      ExpressionResult evaluateMemberAccessExpression(AST::BinaryOperationExpression*);
+      // member access sites cache resolved slots (cache is NULL for computed members)
+      std::optional<ExpressionResult> evaluateStaticMemberAccessExpression(ClassValue*, TaggedValue, MemberCache*);
+      std::optional<ExpressionResult> evaluateInstanceMemberAccessExpression(TaggedValue, TaggedValue, MemberCache*);
+      // identity of the current context class for member caches (0 outside of classes)
+      uint64_t getContextIdentity();
+      // generic member lookup with access checks, returns MEMBER_CACHE_MISS if nothing is found
+      int findStaticMemberSlot(ClassValue*, TaggedValue);
+      int findInstanceMemberSlot(ObjectValue*, TaggedValue);
+      std::optional<ExpressionResult> evaluatePrototypeMemberAccessExpression(TaggedValue, TaggedValue);
 
       // unary expressions
-      Container* evaluateNotExpression(AST::UnaryOperationExpression*);
-      Container* evaluateBitNotExpression(AST::UnaryOperationExpression*);
-      Container* evaluateIncrementExpression(AST::UnaryOperationExpression*);
-      Container* evaluateDecrementExpression(AST::UnaryOperationExpression*);
+      ExpressionResult evaluateNotExpression(AST::UnaryOperationExpression*);
+      ExpressionResult evaluateBitNotExpression(AST::UnaryOperationExpression*);
+      ExpressionResult evaluateIncrementExpression(AST::UnaryOperationExpression*);
+      ExpressionResult evaluateDecrementExpression(AST::UnaryOperationExpression*);
       
       // binary expressions
-      Container* evaluateAdditionExpression(AST::BinaryOperationExpression*);
-      Container* evaluateSubtractionExpression(AST::BinaryOperationExpression*);
-      Container* evaluateMultiplicationExpression(AST::BinaryOperationExpression*);
-      Container* evaluateDivisionExpression(AST::BinaryOperationExpression*);
-      Container* evaluateExponentialExpression(AST::BinaryOperationExpression*);
-      Container* evaluateRemainderExpression(AST::BinaryOperationExpression*);
-      Container* evaluateBitAndExpression(AST::BinaryOperationExpression*);
-      Container* evaluateBitOrExpression(AST::BinaryOperationExpression*);
-      Container* evaluateBitXorExpression(AST::BinaryOperationExpression*);
-      Container* evaluateLeftShiftExpression(AST::BinaryOperationExpression*);
-      Container* evaluateRightShiftExpression(AST::BinaryOperationExpression*);
-      Container* evaluateAdditionAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateSubtractionAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateMultiplicationAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateDivisionAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateExponentialAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateRemainderAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateBitAndAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateBitOrAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateBitXorAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateLeftShiftAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateRightShiftAssignExpression(AST::BinaryOperationExpression*);
-      Container* evaluateAndExpression(AST::BinaryOperationExpression*);
-      Container* evaluateOrExpression(AST::BinaryOperationExpression*);
-      Container* evaluateEqualExpression(AST::BinaryOperationExpression*);
-      Container* evaluateNotEqualExpression(AST::BinaryOperationExpression*);
-      Container* evaluateGreaterThanExpression(AST::BinaryOperationExpression*);
-      Container* evaluateLessThanExpression(AST::BinaryOperationExpression*);
-      Container* evaluateGreaterThanOrEqualExpression(AST::BinaryOperationExpression*);
-      Container* evaluateLessThanOrEqualExpression(AST::BinaryOperationExpression*);
+      ExpressionResult evaluateAndExpression(AST::BinaryOperationExpression*);
+      ExpressionResult evaluateOrExpression(AST::BinaryOperationExpression*);
 
       // grouping expressions
-      Container* evaluateParenthesesExpression(AST::GroupingExpression*);
-      Container* evaluateSquareBracketsExpression(AST::GroupingExpression*);
+      ExpressionResult evaluateParenthesesExpression(AST::GroupingExpression*);
+      ExpressionResult evaluateSquareBracketsExpression(AST::GroupingExpression*);
 
       // grouping application expressions
-      Container* evaluateParenthesesApplicationExpression(AST::GroupingApplicationExpression*);
-      Container* evaluateSquareBracketsApplicationExpression(AST::GroupingApplicationExpression*);
+      ExpressionResult evaluateParenthesesApplicationExpression(AST::GroupingApplicationExpression*);
+      ExpressionResult evaluateSquareBracketsApplicationExpression(AST::GroupingApplicationExpression*);
+      // indexing helpers, index has to be an integer in the vector range
+      bool isIndexExpression(AST::Expression*);
+      TaggedValue evaluateIndexExpression(AST::GroupingApplicationExpression*);
+      VectorValue* getIndexedVector(TaggedValue, AST::Expression*);
+      int getVectorIndex(VectorValue*, TaggedValue, AST::Expression*);
 
       // builtin declarations
       Container* executeBuiltinDeclaration(Builtins::BuiltinDeclaration* statement);
       Container* executeBuiltinConstantDeclaration(Builtins::ConstantBuiltinDeclaration* statement);
       Container* executeBuiltinFunctionDeclaration(Builtins::FunctionBuiltinDeclaration* statement);
 
+      // function calls
+      // script functions get arguments written directly to their frame
+      TaggedValue executeScriptFunction(FunctionValue*, const std::vector<AST::Expression*>&);
+      // closes frame of script function, restores calling stack and context and releases the function
+      void leaveScriptFunction(FunctionValue*, Stack*, ClassValue*);
+      // builtin functions get arguments list
+      TaggedValue executeBuiltinFunction(FunctionValue*, const std::vector<AST::Expression*>&);
+      // creates script function with closure of current stack (context is class for methods)
+      FunctionValue* createScriptFunction(const std::vector<AST::FunctionParameterExpression*>&, AST::BlockStatement*, Value* context);
+
       // memory management
       Stack copyCurrentStack();
       void addScopeInCurrentStack();
       void removeScopeFromCurrentStack();
       void addContainerToCurrentStack(Container*);
-      Container* createExpressionEvaluationContainer(Value*);
-      Container* createTemporaryConstantContainer(Value*);
-      void handleContainerValueReassignment(Container*, Value*);
+      ExpressionResult createExpressionEvaluationResult(TaggedValue);
+      // returns container of assignment target or throws if the target is not assignable
+      Container* getAssignedContainer(ExpressionResult, AST::Expression*);
+      void handleContainerValueReassignment(Container*, TaggedValue);
       
       // utils
       bool isExecutionOnTopLevel();
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cmath>
+#include <functional>
+
+#include "runtime/memory.h"
+#include "runtime/operators.h"
+#include "runtime/strings.h"
+#include "runtime/tagged.h"
+#include "runtime/types.h"
+#include "shared/classes.h"
+
+// this module contains kernels of binary operators
+// kernel computes result from operand values, it does not depend on AST or executor
+// kernels are generated from functors and are stored in table indexed by operator and operand types
+namespace Runtime {
+  inline const int DATA_TYPES_AMOUNT = (int)DataType::Class + 1;
+
+  // functors missing in standard library
+  struct ExponentialOperation {
+    double operator()(double left, double right) const {
+      return std::pow(left, right);
+    }
+  };
+  struct LeftShiftOperation {
+    long long operator()(long long left, long long right) const {
+      return left << right;
+    }
+  };
+  struct RightShiftOperation {
+    long long operator()(long long left, long long right) const {
+      return left >> right;
+    }
+  };
+
+  // number operators
+  template<class Operation>
+  TaggedValue computeNumberKernel(Memory&, TaggedValue left, TaggedValue right) {
+    return TaggedValue::fromNumber(Operation()(left.getNumber(), right.getNumber()));
+  }
+  // integer operators cast operands to long long
+  template<class Operation>
+  TaggedValue computeIntegerKernel(Memory&, TaggedValue left, TaggedValue right) {
+    long long leftValue = left.getNumber();
+    long long rightValue = right.getNumber();
+
+    return TaggedValue::fromNumber(Operation()(leftValue, rightValue));
+  }
+  template<class Operation>
+  TaggedValue computeComparisonKernel(Memory&, TaggedValue left, TaggedValue right) {
+    return TaggedValue::fromBoolean(Operation()(left.getNumber(), right.getNumber()));
+  }
+  // equality is defined for every pair of types
+  template<bool isNegated>
+  TaggedValue computeEqualityKernel(Memory&, TaggedValue left, TaggedValue right) {
+    return TaggedValue::fromBoolean(compareValues(left, right) != isNegated);
+  }
+  inline TaggedValue computeConcatenationKernel(Memory& memory, TaggedValue left, TaggedValue right) {
+    StringValue* leftValue = Shared::Classes::cast<Value, StringValue>(left.getPointer());
+    StringValue* rightValue = Shared::Classes::cast<Value, StringValue>(right.getPointer());
+
+    return memory.createTemporaryString(StringRope::concatenate(leftValue->getRope(), rightValue->getRope()));
+  }
+
+  // NULL kernel means that operator is used with invalid type pair
+  struct BinaryKernelTable {
+    BinaryKernel kernels[KERNEL_OPERATORS_AMOUNT][DATA_TYPES_AMOUNT][DATA_TYPES_AMOUNT];
+  };
+
+  constexpr BinaryKernelTable createBinaryKernelTable() {
+    BinaryKernelTable table = {};
+
+    const int number = (int)DataType::Number;
+    const int string = (int)DataType::String;
+
+    table.kernels[(int)KernelOperator::Addition][number][number] = &computeNumberKernel<std::plus<double>>;
+    table.kernels[(int)KernelOperator::Subtraction][number][number] = &computeNumberKernel<std::minus<double>>;
+    table.kernels[(int)KernelOperator::Multiplication][number][number] = &computeNumberKernel<std::multiplies<double>>;
+    table.kernels[(int)KernelOperator::Division][number][number] = &computeNumberKernel<std::divides<double>>;
+    table.kernels[(int)KernelOperator::Exponential][number][number] = &computeNumberKernel<ExponentialOperation>;
+    table.kernels[(int)KernelOperator::Remainder][number][number] = &computeIntegerKernel<std::modulus<long long>>;
+
+    table.kernels[(int)KernelOperator::BitAnd][number][number] = &computeIntegerKernel<std::bit_and<long long>>;
+    table.kernels[(int)KernelOperator::BitOr][number][number] = &computeIntegerKernel<std::bit_or<long long>>;
+    table.kernels[(int)KernelOperator::BitXor][number][number] = &computeIntegerKernel<std::bit_xor<long long>>;
+    table.kernels[(int)KernelOperator::LeftShift][number][number] = &computeIntegerKernel<LeftShiftOperation>;
+    table.kernels[(int)KernelOperator::RightShift][number][number] = &computeIntegerKernel<RightShiftOperation>;
+
+    table.kernels[(int)KernelOperator::GreaterThan][number][number] = &computeComparisonKernel<std::greater<double>>;
+    table.kernels[(int)KernelOperator::LessThan][number][number] = &computeComparisonKernel<std::less<double>>;
+    table.kernels[(int)KernelOperator::GreaterThanOrEqual][number][number] = &computeComparisonKernel<std::greater_equal<double>>;
+    table.kernels[(int)KernelOperator::LessThanOrEqual][number][number] = &computeComparisonKernel<std::less_equal<double>>;
+
+    table.kernels[(int)KernelOperator::Addition][string][string] = &computeConcatenationKernel;
+
+    for (int left = 0; left < DATA_TYPES_AMOUNT; left++) {
+      for (int right = 0; right < DATA_TYPES_AMOUNT; right++) {
+        table.kernels[(int)KernelOperator::Equal][left][right] = &computeEqualityKernel<false>;
+        table.kernels[(int)KernelOperator::NotEqual][left][right] = &computeEqualityKernel<true>;
+      }
+    }
+
+    return table;
+  }
+
+  inline constexpr BinaryKernelTable BINARY_KERNELS = createBinaryKernelTable();
+
+  inline BinaryKernel getBinaryKernel(KernelOperator operation, DataType leftType, DataType rightType) {
+    return BINARY_KERNELS.kernels[(int)operation][(int)leftType][(int)rightType];
+  }
+}
@@ -1,22 +1,30 @@
 #include "runtime/memory.h"
 #include "runtime/exceptions.h"
 #include "shared/classes.h"
-#include "shared/sets.h"
 
 #include <iostream>
 
 namespace Runtime {
+  TemporariesMark::TemporariesMark(RegionMark regionMark, int valuesAmount): regionMark(regionMark) {
+    this->valuesAmount = valuesAmount;
+  }
+  RegionMark TemporariesMark::getRegionMark() {
+    return this->regionMark;
+  }
+  int TemporariesMark::getValuesAmount() {
+    return this->valuesAmount;
+  }
+
   Memory::Memory() {
     this->prepareStructuresForModules(0);
   }
   Memory::~Memory() {
-    this->removeAllContainers();
-    this->removeAllValues();
+    this->releaseAllStructures();
+    this->releaseInternedStrings();
   }
 
   void Memory::prepareStructuresForModules(int modulesAmount) {
-    this->removeAllContainers();
-    this->removeAllValues();
+    this->releaseAllStructures();
 
     this->stacks = {};
     this->exports = {};
@@ -24,20 +32,8 @@ namespace Runtime {
     this->currentStackIndex = 0;
     this->currentExportsIndex = 0;
 
-    this->containers = {};
-    this->values = {};
-
-    this->containerReferenceCount = {};
-    this->valuesReferenceCount = {};
-
-    this->permanentContainers = {};
-    this->permanentValues = {};
-
-    this->temporaryContainers = {};
     this->temporaryValues = {};
 
-    this->processingValues = {};
-
     for (int i = 0; i < modulesAmount; i++) {
       this->stacks.push_back(Stack());
       this->exports.push_back(ExportsRegistry());
@@ -74,222 +70,465 @@ namespace Runtime {
     return this->currentExportsIndex;
   }
 
+  Allocator& Memory::getAllocator() {
+    return Allocator::getInstance();
+  }
+
   void Memory::retainContainer(Container* container) {
-    this->excludeTemporaryContainer(container);
-    this->containers.insert(container);
-    this->containerReferenceCount[container]++;
+    // retained object is not a candidate of garbage cycle
+    container->setColor(ReferenceColor::Black);
 
-    this->retainValue(container->getValue());
+    // the first reference makes container hold its value
+    if (container->retain() == 1) {
+      container->setValue(this->retainValue(container->getValue()));
+    }
   }
   void Memory::releaseContainer(Container* container) {
-    // decrement container counter
-    int containerCount = --this->containerReferenceCount[container];
+    // containers referenced by closures can be members of garbage cycles
+    if (container->release() > 0) {
+      this->addCandidateContainer(container);
+      return;
+    }
 
-    // release used value
+    // nobody refers to this container
     this->releaseValue(container->getValue());
 
-    // clean if nobody refers to this container
-    if (containerCount <= 0 && !Shared::Sets::includes(this->permanentContainers, container)) {
-      this->removeContainer(container);
+    // temporary containers are deleted when temporaries are cleared
+    if (container->getIsTemporary()) return;
+
+    // buffered containers are deleted by cycle collector
+    if (container->getIsBuffered()) {
+      container->setColor(ReferenceColor::Black);
+      return;
     }
+
+    delete container;
   }
-  void Memory::removeContainer(Container* removingContainer) {
-    std::set<Container*> newContainers = {};
 
-    for (Container* container: this->containers) {
-      if (container == removingContainer && !Shared::Sets::includes(this->permanentContainers, container)) {
-        // delete reference count
-        this->containerReferenceCount.erase(container);
-        // release allocated memory
-        delete container;
+  TaggedValue Memory::retainValue(TaggedValue value) {
+    // null, booleans and numbers are not allocated
+    if (!value.isPointer()) return value;
 
-        continue;
+    Value* heapValue = value.getPointer();
+    // regional values do not outlive the statement
+    if (heapValue->getIsRegional()) heapValue = this->promoteValue(heapValue);
+
+    this->retainHeapValue(heapValue);
+    return TaggedValue::fromPointer(heapValue);
+  }
+  void Memory::releaseValue(TaggedValue value) {
+    // null, booleans and numbers are not allocated
+    if (!value.isPointer()) return;
+    this->releaseHeapValue(value.getPointer());
+  }
+  bool Memory::isUniquelyReferenced(TaggedValue value) {
+    if (!value.isPointer()) return false;
+
+    // temporaries can be referenced by expression results of the current statement
+    Value* heapValue = value.getPointer();
+    return heapValue->getReferenceCount() == 1 && !heapValue->getIsTemporary();
+  }
+  void Memory::retainHeapValue(Value* value) {
+    // retained object is not a candidate of garbage cycle
+    value->setColor(ReferenceColor::Black);
+    value->retain();
+  }
+  void Memory::releaseHeapValue(Value* value) {
+    if (value->release() > 0) {
+      // only compound values can be members of garbage cycles
+      if (Shared::Classes::isInstanceOf<Value, CompoundValue>(value)) {
+        this->addCandidateValue(value);
       }
+      return;
+    }
 
-      newContainers.insert(container);
+    // temporary values are deleted when temporaries are cleared
+    if (!value->getIsTemporary()) {
+      this->removeValue(value);
+    }
+  }
+  void Memory::removeValue(Value* value) {
+    // release values and containers the removed value refers to
+    this->forEachReference(
+      value, 
+      [this](Value* reference) { this->releaseHeapValue(reference); },
+      [this](Container* reference) { this->releaseContainer(reference); }
+    );
+
+    // buffered values are deleted by cycle collector
+    if (value->getIsBuffered()) {
+      value->setColor(ReferenceColor::Black);
+      return;
     }
 
-    this->containers = newContainers;
+    delete value;
   }
 
-  void Memory::retainValue(Value* value) {
-    // clear processing values
-    this->processingValues = {};
+  template<typename ValueVisitor, typename ContainerVisitor>
+  void Memory::forEachReference(Value* value, ValueVisitor visitValue, ContainerVisitor visitContainer) {
+    if (Shared::Classes::isInstanceOf<Value, PrimitiveValue>(value)) return;
+    // typed arrays hold unboxed numbers only
+    if (Shared::Classes::isInstanceOf<Value, Float64ArrayValue>(value)) return;
+    if (Shared::Classes::isInstanceOf<Value, Int64ArrayValue>(value)) return;
 
-    // search all retaining values
-    this->recursivelySearchValues(value);
+    if (Shared::Classes::isInstanceOf<Value, VectorValue>(value)) {
+      // numbers vector has no tagged items
+      const std::vector<TaggedValue>& items = Shared::Classes::cast<Value, VectorValue>(value)->getItems();
+      for (int i = 0; i < items.size(); i++) {
+        if (items[i].isPointer()) visitValue(items[i].getPointer());
+      }
+    }
+    if (Shared::Classes::isInstanceOf<Value, ObjectValue>(value)) {
+      ObjectValue* object = Shared::Classes::cast<Value, ObjectValue>(value);
+      const std::vector<TaggedValue>& values = object->getValues();
+      for (int i = 0; i < values.size(); i++) {
+        if (values[i].isPointer()) visitValue(values[i].getPointer());
+      }
 
-    // decrement pointer for all retaining values
-    for (Value* value: this->processingValues) {
-      this->excludeTemporaryValue(value);
-      this->values.insert(value);
-      this->valuesReferenceCount[value]++;
+      // shape keys are permanent, computed keys are owned by dictionary objects
+      if (object->getIsDictionary()) {
+        for (int i = 0; i < values.size(); i++) {
+          TaggedValue key = object->getDescriptor(i).getKey();
+          if (!isShapeKey(key)) visitValue(key.getPointer());
+        }
+      }
     }
-  }
-  void Memory::releaseValue(Value* value) {
-    // clear processing values
-    this->processingValues = {};
+    if (Shared::Classes::isInstanceOf<Value, MapValue>(value)) {
+      const std::vector<HashTableEntry>& entries = Shared::Classes::cast<Value, MapValue>(value)->getTable().getEntries();
+      for (int i = 0; i < entries.size(); i++) {
+        if (entries[i].isEmpty()) continue;
+        if (entries[i].key.isPointer()) visitValue(entries[i].key.getPointer());
+        if (entries[i].value.isPointer()) visitValue(entries[i].value.getPointer());
+      }
+    }
+    if (Shared::Classes::isInstanceOf<Value, SetValue>(value)) {
+      const std::vector<HashTableEntry>& entries = Shared::Classes::cast<Value, SetValue>(value)->getTable().getEntries();
+      for (int i = 0; i < entries.size(); i++) {
+        if (!entries[i].isEmpty() && entries[i].key.isPointer()) visitValue(entries[i].key.getPointer());
+      }
+    }
+    if (Shared::Classes::isInstanceOf<Value, ClassValue>(value)) {
+      const std::vector<ClassValue*>& parents = Shared::Classes::cast<Value, ClassValue>(value)->getParents();
+      for (int i = 0; i < parents.size(); i++) {
+        visitValue(parents[i]);
+      }
 
-    // search all releasing values
-    this->recursivelySearchValues(value);
+      // keys are interned and permanent, inherited fields hold own references to values
+      const std::vector<Field>& fields = Shared::Classes::cast<Value, ClassValue>(value)->getFields();
+      for (int i = 0; i < fields.size(); i++) {
+        if (fields[i].getValue().isPointer()) visitValue(fields[i].getValue().getPointer());
+      }
+    }
+    // script function closures retain containers of the declaration stack
+    if (Shared::Classes::isInstanceOf<Value, FunctionValue>(value)) {
+      FunctionValue* function = Shared::Classes::cast<Value, FunctionValue>(value);
 
-    // decrement pointer for all releasing values
-    for (Value* value: this->processingValues) {
-      this->valuesReferenceCount[value]--;
+      if (!function->isBuiltin()) {
+        const std::vector<Container*>& containers = function->getClosure()->getContainers();
+        for (int i = 0; i < containers.size(); i++) {
+          visitContainer(containers[i]);
+        }
+      }
     }
-  
-    // init new values list
-    std::set<Value*> newValues = {};
-
-    // save only values that are still in use
-    for (Value* value: this->values) {
-      if (this->valuesReferenceCount[value] > 0 || Shared::Sets::includes(this->permanentValues, value)) {
-        newValues.insert(value);
-      } else {
-        // remove unused value
-        this->valuesReferenceCount.erase(value);
+  }
+
+  void Memory::addCandidateValue(Value* value) {
+    if (value->getColor() == ReferenceColor::Purple) return;
+    value->setColor(ReferenceColor::Purple);
+
+    if (value->getIsBuffered()) return;
+    value->setIsBuffered(true);
+
+    this->candidateValues.push_back(value);
+  }
+  void Memory::addCandidateContainer(Container* container) {
+    if (container->getColor() == ReferenceColor::Purple) return;
+    container->setColor(ReferenceColor::Purple);
+
+    if (container->getIsBuffered()) return;
+    container->setIsBuffered(true);
+
+    this->candidateContainers.push_back(container);
+  }
+
+  void Memory::collectCyclesOnThreshold() {
+    if (this->candidateValues.size() + this->candidateContainers.size() < CYCLE_COLLECTION_CANDIDATES_THRESHOLD) return;
+    this->collectCycles();
+  }
+  void Memory::collectCycles() {
+    std::vector<Value*> rootValues = {};
+    std::vector<Container*> rootContainers = {};
+
+    // mark roots
+    // candidates that were retained again or released to zero are not roots anymore
+    for (int i = 0; i < this->candidateValues.size(); i++) {
+      Value* value = this->candidateValues[i];
+
+      if (value->getColor() == ReferenceColor::Purple && value->getReferenceCount() > 0) {
+        this->markGray(value);
+        rootValues.push_back(value);
+        continue;
+      }
+
+      value->setIsBuffered(false);
+
+      // released value is deleted here as it was buffered
+      if (value->getColor() == ReferenceColor::Black && value->getReferenceCount() <= 0 && !value->getIsTemporary()) {
         delete value;
       }
     }
+    for (int i = 0; i < this->candidateContainers.size(); i++) {
+      Container* container = this->candidateContainers[i];
 
-    // update values list
-    this->values = newValues;
+      if (container->getColor() == ReferenceColor::Purple && container->getReferenceCount() > 0) {
+        this->markGray(container);
+        rootContainers.push_back(container);
+        continue;
+      }
+
+      container->setIsBuffered(false);
+
+      // released container is deleted here as it was buffered
+      if (container->getColor() == ReferenceColor::Black && container->getReferenceCount() <= 0 && !container->getIsTemporary()) {
+        delete container;
+      }
+    }
+
+    this->candidateValues = {};
+    this->candidateContainers = {};
+
+    // scan roots
+    for (int i = 0; i < rootValues.size(); i++) {
+      this->scan(rootValues[i]);
+    }
+    for (int i = 0; i < rootContainers.size(); i++) {
+      this->scan(rootContainers[i]);
+    }
+
+    // collect roots
+    for (int i = 0; i < rootValues.size(); i++) {
+      rootValues[i]->setIsBuffered(false);
+    }
+    for (int i = 0; i < rootContainers.size(); i++) {
+      rootContainers[i]->setIsBuffered(false);
+    }
+    for (int i = 0; i < rootValues.size(); i++) {
+      this->collectWhite(rootValues[i]);
+    }
+    for (int i = 0; i < rootContainers.size(); i++) {
+      this->collectWhite(rootContainers[i]);
+    }
+
+    // garbage is deleted after collection as it can be reached by several references
+    for (int i = 0; i < this->garbageValues.size(); i++) {
+      delete this->garbageValues[i];
+    }
+    for (int i = 0; i < this->garbageContainers.size(); i++) {
+      delete this->garbageContainers[i];
+    }
+
+    this->garbageValues = {};
+    this->garbageContainers = {};
   }
 
-  void Memory::addPermanentContainer(Container* container) {
-    this->permanentContainers.insert(container);
-    this->addPermanentValue(container->getValue());
+  void Memory::markGray(Value* value) {
+    if (value->getColor() == ReferenceColor::Gray) return;
+    value->setColor(ReferenceColor::Gray);
+
+    this->forEachReference(
+      value,
+      [this](Value* reference) { reference->release(); this->markGray(reference); },
+      [this](Container* reference) { reference->release(); this->markGray(reference); }
+    );
   }
-  void Memory::addPermanentValue(Value* value) {
-    // clear processing values
-    this->processingValues = {};
+  void Memory::markGray(Container* container) {
+    if (container->getColor() == ReferenceColor::Gray) return;
+    container->setColor(ReferenceColor::Gray);
 
-    // search all retaining values
-    this->recursivelySearchValues(value);
+    if (!container->getValue().isPointer()) return;
+
+    Value* value = container->getValue().getPointer();
+    value->release();
+    this->markGray(value);
+  }
 
-    // decrement pointer for all permanent values
-    for (Value* value: this->processingValues) {
-      this->permanentValues.insert(value);
+  void Memory::scan(Value* value) {
+    if (value->getColor() != ReferenceColor::Gray) return;
+
+    // temporaries are referenced by evaluated expressions
+    if (value->getReferenceCount() > 0 || value->getIsTemporary()) {
+      this->scanBlack(value);
+      return;
     }
+
+    value->setColor(ReferenceColor::White);
+    this->forEachReference(
+      value,
+      [this](Value* reference) { this->scan(reference); },
+      [this](Container* reference) { this->scan(reference); }
+    );
   }
+  void Memory::scan(Container* container) {
+    if (container->getColor() != ReferenceColor::Gray) return;
 
-  void Memory::addTemporaryContainer(Container* container) {
-    if (!Shared::Sets::includes(this->containers, container)) {
-      this->temporaryContainers.insert(container);
+    // temporaries are referenced by evaluated expressions
+    if (container->getReferenceCount() > 0 || container->getIsTemporary()) {
+      this->scanBlack(container);
+      return;
     }
+
+    container->setColor(ReferenceColor::White);
+    if (container->getValue().isPointer()) this->scan(container->getValue().getPointer());
   }
-  void Memory::excludeTemporaryContainer(Container* container) {
-    this->temporaryContainers.erase(container);
+
+  void Memory::scanBlack(Value* value) {
+    value->setColor(ReferenceColor::Black);
+
+    this->forEachReference(
+      value,
+      [this](Value* reference) { 
+        reference->retain(); 
+        if (reference->getColor() != ReferenceColor::Black) this->scanBlack(reference); 
+      },
+      [this](Container* reference) { 
+        reference->retain(); 
+        if (reference->getColor() != ReferenceColor::Black) this->scanBlack(reference); 
+      }
+    );
   }
-  void Memory::clearTemporaryContainers() {
-    for (Container* container: this->temporaryContainers) {
-      delete container;
-    }
-    this->temporaryContainers = {};
+  void Memory::scanBlack(Container* container) {
+    container->setColor(ReferenceColor::Black);
+
+    if (!container->getValue().isPointer()) return;
+
+    Value* value = container->getValue().getPointer();
+    value->retain();
+    if (value->getColor() != ReferenceColor::Black) this->scanBlack(value);
   }
 
-  void Memory::addTemporaryValue(Value* value) {
-    if (!Shared::Sets::includes(this->values, value)) {
-      this->temporaryValues.insert(value);
-    }
+  void Memory::collectWhite(Value* value) {
+    if (value->getColor() != ReferenceColor::White || value->getIsBuffered()) return;
+    value->setColor(ReferenceColor::Black);
+
+    this->forEachReference(
+      value,
+      [this](Value* reference) { this->collectWhite(reference); },
+      [this](Container* reference) { this->collectWhite(reference); }
+    );
+
+    this->garbageValues.push_back(value);
   }
-  void Memory::excludeTemporaryValue(Value* value) {
-    this->temporaryValues.erase(value);
+  void Memory::collectWhite(Container* container) {
+    if (container->getColor() != ReferenceColor::White || container->getIsBuffered()) return;
+    container->setColor(ReferenceColor::Black);
+
+    if (container->getValue().isPointer()) this->collectWhite(container->getValue().getPointer());
+
+    this->garbageContainers.push_back(container);
   }
-  void Memory::clearTemporaryValues() {
-    for (Value* value: this->temporaryValues) {
-      delete value;
-    }
-    this->temporaryValues = {};
+
+  void Memory::addPermanentContainer(Container* container) {
+    // permanent reference is never released
+    this->retainContainer(container);
+  }
+  void Memory::addPermanentValue(TaggedValue value) {
+    // permanent reference is never released
+    this->retainValue(value);
   }
 
-  void Memory::removeUnreachableValues() {
-    // remove processing values
-    this->processingValues = {};
+  void Memory::addTemporaryValue(TaggedValue taggedValue) {
+    // null, booleans and numbers are not allocated
+    if (!taggedValue.isPointer()) return;
 
-    // search all accessible values
-    for (Container* container: this->containers) {
-      this->recursivelySearchValues(container->getValue());
-    }
+    Value* value = taggedValue.getPointer();
+    if (value->getIsTemporary()) return;
 
-    // if no memory lost, stop procedure
-    if (this->processingValues.size() == this->values.size()) return;
+    value->setIsTemporary(true);
+    this->temporaryValues.push_back(value);
+  }
 
-    std::set<Value*> newValues = {};
+  TaggedValue Memory::internString(std::string_view data) {
+    auto interned = this->internedStrings.find(data);
+    if (interned != this->internedStrings.end()) return TaggedValue::fromPointer(interned->second);
 
-    // delete all values that are not accessible
-    for (Value* value: this->values) {
-      if (Shared::Sets::includes(this->processingValues, value)) {
-        newValues.insert(value);
-      } else {
-        // remove value
-        this->valuesReferenceCount.erase(value);
-        delete value;
-      }
+    StringValue* value = new StringValue(std::string(data));
+    value->setIsInterned(true);
+
+    // interned strings are shared, so they are never extended in place
+    this->addPermanentValue(TaggedValue::fromPointer(value));
+    this->internedStrings[value->getData()] = value;
+
+    return TaggedValue::fromPointer(value);
+  }
+  Shape* Memory::getRootShape() {
+    return &this->rootShape;
+  }
+  void Memory::releaseInternedStrings() {
+    for (auto& interned : this->internedStrings) {
+      this->releaseValue(TaggedValue::fromPointer(interned.second));
     }
+    this->internedStrings.clear();
+  }
 
-    this->values = newValues;
+  TaggedValue Memory::createTemporaryString(std::string data) {
+    return this->createTemporaryString(std::make_shared<StringRope>(std::move(data)));
   }
-  void Memory::recursivelySearchValues(Value* value) {
-    // skip already analyzed value
-    if (Shared::Sets::includes(this->processingValues, value)) return;
+  TaggedValue Memory::createTemporaryString(std::shared_ptr<StringRope> rope) {
+    StringValue* value = new (this->temporariesRegion.allocate(sizeof(StringValue))) StringValue(std::move(rope));
+    value->setIsTemporary(true);
+    value->setIsRegional(true);
 
-    // analyze current value
-    this->processingValues.insert(value);
-    
-    // analyze current value children
-    if (Shared::Classes::isInstanceOf<Value, PrimitiveValue>(value)) return;
-    if (Shared::Classes::isInstanceOf<Value, VectorValue>(value)) {
-      std::vector<Value*> items = Shared::Classes::cast<Value, VectorValue>(value)->getItems();
-  
-      for (int i = 0; i < items.size(); i++) {
-        this->recursivelySearchValues(items[i]);
-      }
-    }
-    if (Shared::Classes::isInstanceOf<Value, ObjectValue>(value)) {
-      std::vector<Field> fields = Shared::Classes::cast<Value, ObjectValue>(value)->getEntries();
-      for (int i = 0; i < fields.size(); i++) {
-        this->recursivelySearchValues(fields[i].getKey());
-        this->recursivelySearchValues(fields[i].getValue());
-      }
-    }
-    if (Shared::Classes::isInstanceOf<Value, ClassValue>(value)) {
-      std::vector<ClassValue*> parents = Shared::Classes::cast<Value, ClassValue>(value)->getParents();
-      for (int i = 0; i < parents.size(); i++) {
-        this->recursivelySearchValues(parents[i]);
-      }
+    // string rope is owned outside of region
+    this->temporariesRegion.addFinalizer(value);
 
-      std::vector<Field> fields = Shared::Classes::cast<Value, ClassValue>(value)->getFields();
-      for (int i = 0; i < fields.size(); i++) {
-        this->recursivelySearchValues(fields[i].getKey());
-        this->recursivelySearchValues(fields[i].getValue());
+    return TaggedValue::fromPointer(value);
+  }
+  Value* Memory::promoteValue(Value* value) {
+    // only strings are allocated in region, they are copied-by-value
+    return new StringValue(*Shared::Classes::cast<Value, StringValue>(value));
+  }
+
+  TemporariesMark Memory::getTemporariesMark() {
+    return TemporariesMark(this->temporariesRegion.getMark(), this->temporaryValues.size());
+  }
+  void Memory::clearTemporaries(TemporariesMark mark) {
+    // regional strings are freed by moving the region pointer back
+    this->temporariesRegion.reset(mark.getRegionMark());
+
+    for (int i = mark.getValuesAmount(); i < this->temporaryValues.size(); i++) {
+      Value* value = this->temporaryValues[i];
+      value->setIsTemporary(false);
+
+      // delete values nobody refers to
+      if (value->getReferenceCount() <= 0) {
+        this->removeValue(value);
       }
     }
-    if (Shared::Classes::isInstanceOf<Value, FunctionValue>(value)) {
-      FunctionValue* functionValue = Shared::Classes::cast<Value, FunctionValue>(value);
-      this->recursivelySearchValues(functionValue);
-
-      std::vector<Container*> containers = functionValue->getClosure()->getContainers();
-      for (int i = 0; i < containers.size(); i++) {
-        this->recursivelySearchValues(containers[i]->getValue());        
-      } 
-    };
+    this->temporaryValues.resize(mark.getValuesAmount());
   }
 
-  void Memory::removeAllContainers() {
-    for (Container* container: this->containers) {
-      delete container;
+  void Memory::releaseAllStructures() {
+    // temporaries do not refer to structures
+    this->clearTemporaries(TemporariesMark(RegionMark(0, 0, 0), 0));
+
+    for (int i = 0; i < this->exports.size(); i++) {
+      const std::vector<Container*>& containers = this->exports[i].getContainers();
+      for (int j = 0; j < containers.size(); j++) {
+        this->releaseContainer(containers[j]);
+      }
     }
 
-    this->containers = {};
-    this->containerReferenceCount = {};
-  }
-  void Memory::removeAllValues() {
-    for (Value* value: this->values) {
-      delete value;
+    for (int i = 0; i < this->stacks.size(); i++) {
+      const std::vector<Container*>& containers = this->stacks[i].getContainers();
+      for (int j = 0; j < containers.size(); j++) {
+        this->releaseContainer(containers[j]);
+      }
     }
 
-    this->values = {};
-    this->valuesReferenceCount = {};
+    // delete garbage cycles left after releasing structures
+    this->collectCycles();
+
+    this->exports = {};
+    this->stacks = {};
   }
 }
@@ -1,12 +1,33 @@
 #pragma once
 
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
-#include <set>
 
+#include "runtime/allocator.h"
+#include "runtime/region.h"
+#include "runtime/shapes.h"
 #include "runtime/stack.h"
 #include "runtime/types.h"
 
 namespace Runtime {
+  // amount of candidates of garbage cycles roots that triggers cycle collection
+  inline const int CYCLE_COLLECTION_CANDIDATES_THRESHOLD = 1024;
+
+  // position in temporaries region and list
+  class TemporariesMark {
+    private:
+      RegionMark regionMark;
+      int valuesAmount;
+
+    public:
+      TemporariesMark(RegionMark regionMark, int valuesAmount);
+
+      RegionMark getRegionMark();
+      int getValuesAmount();
+  };
+
   // is responsible for memory usage and deallocation
   class Memory {
     private:
@@ -26,45 +47,62 @@ namespace Runtime {
       int currentStackIndex;
       int currentExportsIndex;
       
-      // keeps track of all used variables (containers)
-      // containers only point to values, flat structure
-      // flat structure -> retain/release is enough
-      std::set<Container*> containers;
-      // keeps track of all used values (containers point to value)
-      // values can point to other values, cyclic structure
-      // cyclic structure -> has to be released recursively and checked for accessibility
-      std::set<Value*> values;
-      
-      // count allocated memory references
-      // used to release memory when nobody uses it
-      std::unordered_map<Container*, int> containerReferenceCount;
-      std::unordered_map<Value*, int> valuesReferenceCount;
-
-      // holds list of pointers to permanent containers
-      // are used for classes and type definitions
-      std::set<Container*> permanentContainers;
-      // holds list of pointers to permanent values
-      // are used for classes and type definitions
-      std::set<Value*> permanentValues;
-      
-      // holds list of pointers to temporary containers
-      // temporary containers are used for expressions
-      std::set<Container*> temporaryContainers;
-      // holds list of pointers to temporary values 
+      // bump pointer region of expression temporaries
+      // holds temporary strings, is reset to the mark of each statement
+      Region temporariesRegion;
+      // holds list of pointers to temporary heap values 
       // temporary values are used for expression computations
-      std::set<Value*> temporaryValues;
-      
-      // utility that optimizes value operations
-      // searches value and its children and adds them to this.processingValues
-      void recursivelySearchValues(Value*);
-      // used during operations to prevent loops
-      // particularly used for recursive values releasing
-      std::set<Value*> processingValues;
-      
-      // deletes all containers and counts
-      void removeAllContainers();
-      // deletes all values and counts
-      void removeAllValues();
+      std::vector<Value*> temporaryValues;
+
+      // copies regional value to the heap when it is referenced by a structure
+      Value* promoteValue(Value*);
+
+      // unique strings of literals and member keys
+      // keys are views of interned values data (interned values are never modified)
+      std::unordered_map<std::string_view, StringValue*> internedStrings;
+      // releases interned strings when memory is destroyed
+      void releaseInternedStrings();
+
+      // root of shapes transition tree, owns all the shapes
+      Shape rootShape;
+
+      // heap values reference counting
+      void retainHeapValue(Value*);
+      void releaseHeapValue(Value*);
+      // deletes value and releases values and containers it refers to
+      void removeValue(Value*);
+
+      // calls visitors for heap values and containers the value refers to
+      template<typename ValueVisitor, typename ContainerVisitor>
+      void forEachReference(Value*, ValueVisitor, ContainerVisitor);
+
+      // candidates of garbage cycles roots
+      // contain values and containers which were released without reaching zero
+      std::vector<Value*> candidateValues;
+      std::vector<Container*> candidateContainers;
+
+      // buffers possible root of garbage cycle
+      void addCandidateValue(Value*);
+      void addCandidateContainer(Container*);
+
+      // trial deletion steps
+      // subtracts internal references of subgraph
+      void markGray(Value*);
+      void markGray(Container*);
+      // restores subgraphs that are referenced externally and marks others as garbage
+      void scan(Value*);
+      void scan(Container*);
+      void scanBlack(Value*);
+      void scanBlack(Container*);
+      // gathers garbage
+      void collectWhite(Value*);
+      void collectWhite(Container*);
+      // garbage gathered by collection
+      std::vector<Value*> garbageValues;
+      std::vector<Container*> garbageContainers;
+
+      // releases containers of all stacks and exports registries
+      void releaseAllStructures();
 
     public:
       Memory();
@@ -88,36 +126,52 @@ namespace Runtime {
       int getCurrentExportsRegistryIndex();
       
       // control containers usage
-      // increment pointer reference count
+      // increment container reference count (the first reference retains container value)
       void retainContainer(Container* container);
-      // decrement pointer reference count and deletes container if nobody uses it
+      // decrement container reference count and delete container if nobody uses it
       void releaseContainer(Container* container);
-      // deletes container by pointer from containers list
-      void removeContainer(Container*);
 
       // control values usage
-      // increment pointer reference count
-      void retainValue(Value* value);
-      // decrement pointer reference count and remove unused values recursively
-      void releaseValue(Value* value);
+      // increment value reference count (only heap values are counted)
+      // regional values are promoted to the heap, the returned value has to be stored instead
+      TaggedValue retainValue(TaggedValue value);
+      // decrement value reference count and delete value if nobody uses it
+      void releaseValue(TaggedValue value);
+      // checks if the only reference to heap value is held by one container or structure
+      // such values can be mutated in place without being observed through other references
+      bool isUniquelyReferenced(TaggedValue value);
 
-      // methods to work with permanent containers
+      // permanent containers and values are never deleted
+      // are used for classes and type definitions
       void addPermanentContainer(Container*);
-      // methods to work with permanent values
-      void addPermanentValue(Value*);
-      
-      // methods to work with temp containers
-      void addTemporaryContainer(Container*);
-      void excludeTemporaryContainer(Container*);
-      void clearTemporaryContainers();
-
-      // methods to work with temp values
-      void addTemporaryValue(Value*);
-      void excludeTemporaryValue(Value*);
-      void clearTemporaryValues();
+      void addPermanentValue(TaggedValue);
       
-      // clears values that are not accessible through any container
-      // removes cycled references 
-      void removeUnreachableValues();
+      // methods to work with temporaries
+      // temporaries are not deleted when they are released, only when they are cleared
+      void addTemporaryValue(TaggedValue);
+      // returns the unique permanent string with given content
+      // interned strings are used for literals and member keys and are compared by pointer
+      TaggedValue internString(std::string_view data);
+
+      // shape of objects without entries
+      Shape* getRootShape();
+
+      // temporary strings are allocated in region
+      TaggedValue createTemporaryString(std::string data);
+      TaggedValue createTemporaryString(std::shared_ptr<StringRope> rope);
+
+      // values and containers are allocated by runtime allocator
+      // is used to get allocation stats (live and free slots)
+      Allocator& getAllocator();
+
+      // collects garbage cycles reachable from candidates
+      // is called when candidates amount hits the threshold
+      void collectCycles();
+      void collectCyclesOnThreshold();
+
+      // temporaries are cleared in nested regions (statements, loop iterations)
+      // only temporaries created after the mark are cleared
+      TemporariesMark getTemporariesMark();
+      void clearTemporaries(TemporariesMark);
   };
 }
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "runtime/tagged.h"
+#include "specification/specification.h"
+
+namespace Runtime {
+  // kernels allocate results in memory (from runtime/memory.h)
+  class Memory;
+
+  // operators that are computed from values of both operands
+  // used as index of binary kernels table
+  enum class KernelOperator {
+    Addition,
+    Subtraction,
+    Multiplication,
+    Division,
+    Exponential,
+    Remainder,
+
+    BitAnd,
+    BitOr,
+    BitXor,
+    LeftShift,
+    RightShift,
+
+    Equal,
+    NotEqual,
+    GreaterThan,
+    LessThan,
+    GreaterThanOrEqual,
+    LessThanOrEqual,
+
+    // operators without kernel (assignment, member access, logical operators)
+    None,
+  };
+
+  inline const int KERNEL_OPERATORS_AMOUNT = (int)KernelOperator::None;
+
+  // computes result of operator from operand values (kernels are defined in runtime/kernels.h)
+  using BinaryKernel = TaggedValue (*)(Memory&, TaggedValue, TaggedValue);
+
+  // maps operator token to kernel operator (None for other operators)
+  inline KernelOperator getKernelOperator(Specification::TokenType type) {
+    switch (type) {
+      case Specification::TokenType::PLUS_TOKEN: return KernelOperator::Addition;
+      case Specification::TokenType::MINUS_TOKEN: return KernelOperator::Subtraction;
+      case Specification::TokenType::MULTIPLICATION_TOKEN: return KernelOperator::Multiplication;
+      case Specification::TokenType::DIVISION_TOKEN: return KernelOperator::Division;
+      case Specification::TokenType::EXPONENTIAL_TOKEN: return KernelOperator::Exponential;
+      case Specification::TokenType::REMAINDER_TOKEN: return KernelOperator::Remainder;
+
+      case Specification::TokenType::BIT_AND_TOKEN: return KernelOperator::BitAnd;
+      case Specification::TokenType::BIT_OR_TOKEN: return KernelOperator::BitOr;
+      case Specification::TokenType::BIT_XOR_TOKEN: return KernelOperator::BitXor;
+      case Specification::TokenType::LEFT_SHIFT_TOKEN: return KernelOperator::LeftShift;
+      case Specification::TokenType::RIGHT_SHIFT_TOKEN: return KernelOperator::RightShift;
+
+      case Specification::TokenType::EQUAL_TOKEN: return KernelOperator::Equal;
+      case Specification::TokenType::NOT_EQUAL_TOKEN: return KernelOperator::NotEqual;
+      case Specification::TokenType::GREATER_THAN_TOKEN: return KernelOperator::GreaterThan;
+      case Specification::TokenType::LESS_THAN_TOKEN: return KernelOperator::LessThan;
+      case Specification::TokenType::GREATER_THAN_OR_EQUAL_TOKEN: return KernelOperator::GreaterThanOrEqual;
+      case Specification::TokenType::LESS_THAN_OR_EQUAL_TOKEN: return KernelOperator::LessThanOrEqual;
+
+      default: return KernelOperator::None;
+    }
+  }
+
+  // maps compound assignment token to kernel of its operator (None for other operators)
+  inline KernelOperator getAssignKernelOperator(Specification::TokenType type) {
+    switch (type) {
+      case Specification::TokenType::PLUS_ASSIGN_TOKEN: return KernelOperator::Addition;
+      case Specification::TokenType::MINUS_ASSIGN_TOKEN: return KernelOperator::Subtraction;
+      case Specification::TokenType::MULTIPLICATION_ASSIGN_TOKEN: return KernelOperator::Multiplication;
+      case Specification::TokenType::DIVISION_ASSIGN_TOKEN: return KernelOperator::Division;
+      case Specification::TokenType::EXPONENTIAL_ASSIGN_TOKEN: return KernelOperator::Exponential;
+      case Specification::TokenType::REMAINDER_ASSIGN_TOKEN: return KernelOperator::Remainder;
+
+      case Specification::TokenType::BIT_AND_ASSIGN_TOKEN: return KernelOperator::BitAnd;
+      case Specification::TokenType::BIT_OR_ASSIGN_TOKEN: return KernelOperator::BitOr;
+      case Specification::TokenType::BIT_XOR_ASSIGN_TOKEN: return KernelOperator::BitXor;
+      case Specification::TokenType::LEFT_SHIFT_ASSIGN_TOKEN: return KernelOperator::LeftShift;
+      case Specification::TokenType::RIGHT_SHIFT_ASSIGN_TOKEN: return KernelOperator::RightShift;
+
+      default: return KernelOperator::None;
+    }
+  }
+}
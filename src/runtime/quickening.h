@@ -0,0 +1,92 @@
+#pragma once
+
+#include "runtime/operators.h"
+#include "runtime/tagged.h"
+
+namespace Runtime {
+  // amount of evaluations with the same operand types before site is quickened
+  inline const int QUICKENING_THRESHOLD = 2;
+  // site that falls back to generic path this many times is not quickened anymore
+  inline const int MAXIMUM_DEQUICKENINGS_AMOUNT = 4;
+
+  // inline type profile of binary operation site
+  // quickened site keeps the kernel of observed operand types and skips table dispatch
+  // sites quickened for two numbers keep their operator, so executor computes common operators inline
+  // methods are defined in the header to be inlined in operations
+  class OperationProfile {
+    private:
+      DataType leftType;
+      DataType rightType;
+      // amount of consecutive evaluations with the same operand types
+      int hits;
+      int dequickeningsAmount;
+      // generic sites are not profiled anymore
+      bool isGeneric;
+
+      // is valid only for operands of profiled types
+      BinaryKernel kernel;
+      // None if site is not quickened for two numbers
+      KernelOperator numberOperator;
+
+    public:
+      OperationProfile(): leftType(DataType::Null), rightType(DataType::Null), hits(0), dequickeningsAmount(0), isGeneric(false), kernel(NULL), numberOperator(KernelOperator::None) {}
+
+      bool getIsQuickened() const {
+        return this->kernel != NULL;
+      }
+      bool getIsGeneric() const {
+        return this->isGeneric;
+      }
+      BinaryKernel getKernel() const {
+        return this->kernel;
+      }
+      KernelOperator getNumberOperator() const {
+        return this->numberOperator;
+      }
+
+      // records operand types of generic evaluation
+      // returns true if site is monomorphic and can be quickened
+      bool record(DataType leftType, DataType rightType) {
+        if (this->hits && leftType == this->leftType && rightType == this->rightType) {
+          this->hits++;
+        } else {
+          this->leftType = leftType;
+          this->rightType = rightType;
+          this->hits = 1;
+        }
+
+        return this->hits >= QUICKENING_THRESHOLD;
+      }
+      DataType getLeftType() const {
+        return this->leftType;
+      }
+      DataType getRightType() const {
+        return this->rightType;
+      }
+
+      // operations without kernel for observed types stay generic
+      void quicken(KernelOperator operation, BinaryKernel kernel) {
+        if (kernel == NULL) {
+          this->isGeneric = true;
+          return;
+        }
+
+        this->kernel = kernel;
+
+        if (this->leftType == DataType::Number && this->rightType == DataType::Number) {
+          this->numberOperator = operation;
+        }
+      }
+      // called when quickened site gets operands of other types
+      void dequicken() {
+        this->kernel = NULL;
+        this->numberOperator = KernelOperator::None;
+        this->hits = 0;
+        this->dequickeningsAmount++;
+
+        if (this->dequickeningsAmount >= MAXIMUM_DEQUICKENINGS_AMOUNT) {
+          this->isGeneric = true;
+        }
+      }
+  };
+}
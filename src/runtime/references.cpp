@@ -0,0 +1,69 @@
+#include "runtime/references.h"
+#include "runtime/allocator.h"
+
+namespace Runtime {
+  ReferenceCounted::ReferenceCounted() {
+    this->referenceCount = 0;
+    this->isTemporary = false;
+    this->isRegional = false;
+    this->color = ReferenceColor::Black;
+    this->isBuffered = false;
+  }
+  ReferenceCounted::ReferenceCounted(const ReferenceCounted&) {
+    this->referenceCount = 0;
+    this->isTemporary = false;
+    this->isRegional = false;
+    this->color = ReferenceColor::Black;
+    this->isBuffered = false;
+  }
+
+  void* ReferenceCounted::operator new(size_t size) {
+    return Allocator::getInstance().allocate(size);
+  }
+  void ReferenceCounted::operator delete(void* pointer, size_t size) {
+    Allocator::getInstance().deallocate(pointer, size);
+  }
+  void* ReferenceCounted::operator new(size_t, void* place) {
+    return place;
+  }
+  void ReferenceCounted::operator delete(void*, void*) {}
+
+  int ReferenceCounted::retain() {
+    return ++this->referenceCount;
+  }
+  int ReferenceCounted::release() {
+    return --this->referenceCount;
+  }
+
+  int ReferenceCounted::getReferenceCount() {
+    return this->referenceCount;
+  }
+
+  bool ReferenceCounted::getIsTemporary() {
+    return this->isTemporary;
+  }
+  void ReferenceCounted::setIsTemporary(bool isTemporary) {
+    this->isTemporary = isTemporary;
+  }
+
+  bool ReferenceCounted::getIsRegional() {
+    return this->isRegional;
+  }
+  void ReferenceCounted::setIsRegional(bool isRegional) {
+    this->isRegional = isRegional;
+  }
+
+  ReferenceColor ReferenceCounted::getColor() {
+    return this->color;
+  }
+  void ReferenceCounted::setColor(ReferenceColor color) {
+    this->color = color;
+  }
+
+  bool ReferenceCounted::getIsBuffered() {
+    return this->isBuffered;
+  }
+  void ReferenceCounted::setIsBuffered(bool isBuffered) {
+    this->isBuffered = isBuffered;
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Runtime {
+  // colors of cycle collection (trial deletion)
+  enum class ReferenceColor {
+    // in use or free
+    Black,
+    // possible member of garbage cycle
+    Gray,
+    // member of garbage cycle
+    White,
+    // possible root of garbage cycle
+    Purple,
+  };
+
+  // intrusive header of memory managed objects (values and containers)
+  // reference count and memory flags are stored directly in the object
+  // so retain and release do not touch any memory bookkeeping structures
+  class ReferenceCounted {
+    private:
+      // amount of references to the object (containers, compound values, stacks, exports)
+      int referenceCount;
+      // temporary objects are listed in memory and are deleted when temporaries are cleared
+      // they are not deleted when reference count drops to zero
+      bool isTemporary;
+      // regional objects are placed in temporaries region and are never deleted
+      // they are freed together when the region is reset
+      bool isRegional;
+
+      // cycle collection state
+      ReferenceColor color;
+      // buffered objects are listed in cycle collection candidates and are deleted by collector
+      bool isBuffered;
+
+    public:
+      ReferenceCounted();
+      // copies do not inherit references of the original object
+      ReferenceCounted(const ReferenceCounted&);
+
+      // memory managed objects are allocated by runtime allocator (slabs of size classes)
+      // deleting through base pointer passes the size of the most derived object
+      static void* operator new(size_t);
+      static void operator delete(void*, size_t);
+      // temporaries are placed in region memory
+      static void* operator new(size_t, void*);
+      static void operator delete(void*, void*);
+
+      // return updated reference count
+      int retain();
+      int release();
+
+      int getReferenceCount();
+
+      bool getIsTemporary();
+      void setIsTemporary(bool);
+
+      bool getIsRegional();
+      void setIsRegional(bool);
+
+      ReferenceColor getColor();
+      void setColor(ReferenceColor);
+
+      bool getIsBuffered();
+      void setIsBuffered(bool);
+  };
+}
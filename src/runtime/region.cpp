@@ -0,0 +1,76 @@
+#include "runtime/region.h"
+#include "runtime/types.h"
+
+#include <new>
+
+namespace Runtime {
+  RegionMark::RegionMark(int chunkIndex, int offset, int finalizersAmount) {
+    this->chunkIndex = chunkIndex;
+    this->offset = offset;
+    this->finalizersAmount = finalizersAmount;
+  }
+  int RegionMark::getChunkIndex() {
+    return this->chunkIndex;
+  }
+  int RegionMark::getOffset() {
+    return this->offset;
+  }
+  int RegionMark::getFinalizersAmount() {
+    return this->finalizersAmount;
+  }
+
+  Region::Region() {
+    this->chunks = {};
+    this->chunkIndex = 0;
+    this->offset = 0;
+    this->finalizers = {};
+
+    this->chunks.push_back((char*)::operator new(REGION_CHUNK_SIZE));
+  }
+  Region::~Region() {
+    this->reset(RegionMark(0, 0, 0));
+
+    for (int i = 0; i < this->chunks.size(); i++) {
+      ::operator delete(this->chunks[i]);
+    }
+  }
+
+  void* Region::allocate(size_t size) {
+    size = (size + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+
+    // go to the next chunk if the current one is full
+    if (this->offset + size > REGION_CHUNK_SIZE) {
+      this->chunkIndex++;
+      this->offset = 0;
+
+      if (this->chunkIndex == this->chunks.size()) {
+        this->chunks.push_back((char*)::operator new(REGION_CHUNK_SIZE));
+      }
+    }
+
+    void* pointer = this->chunks[this->chunkIndex] + this->offset;
+    this->offset += size;
+
+    return pointer;
+  }
+  void Region::addFinalizer(Value* value) {
+    this->finalizers.push_back(value);
+  }
+
+  RegionMark Region::getMark() {
+    return RegionMark(this->chunkIndex, this->offset, this->finalizers.size());
+  }
+  void Region::reset(RegionMark mark) {
+    for (int i = mark.getFinalizersAmount(); i < this->finalizers.size(); i++) {
+      this->finalizers[i]->~Value();
+    }
+    this->finalizers.resize(mark.getFinalizersAmount());
+
+    this->chunkIndex = mark.getChunkIndex();
+    this->offset = mark.getOffset();
+  }
+
+  int Region::getChunksAmount() {
+    return this->chunks.size();
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Runtime {
+  // forward declaration (from types.h)
+  class Value;
+
+  // size of region chunk
+  inline const int REGION_CHUNK_SIZE = 64 * 1024;
+  // alignment of region allocations
+  inline const int REGION_ALIGNMENT = 16;
+
+  // position in region
+  class RegionMark {
+    private:
+      int chunkIndex;
+      int offset;
+      int finalizersAmount;
+
+    public:
+      RegionMark(int chunkIndex, int offset, int finalizersAmount);
+
+      int getChunkIndex();
+      int getOffset();
+      int getFinalizersAmount();
+  };
+
+  // bump pointer allocator of temporaries
+  // objects allocated after the mark are freed together by moving the pointer back to the mark
+  // chunks are kept to be reused by next allocations
+  class Region {
+    private:
+      std::vector<char*> chunks;
+
+      // current allocation position
+      int chunkIndex;
+      int offset;
+
+      // values that own memory outside of region and have to be destructed on reset
+      std::vector<Value*> finalizers;
+
+    public:
+      Region();
+      Region(const Region&) = delete;
+      Region& operator=(const Region&) = delete;
+      ~Region();
+
+      void* allocate(size_t);
+      // value is destructed when the region is reset below it
+      void addFinalizer(Value*);
+
+      RegionMark getMark();
+      void reset(RegionMark);
+
+      int getChunksAmount();
+  };
+}
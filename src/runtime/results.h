@@ -0,0 +1,44 @@
+#pragma once
+
+#include "runtime/stack.h"
+#include "runtime/tagged.h"
+
+namespace Runtime {
+  // result of expression evaluation
+  // is either a reference to existing container (lvalue) or a plain value (rvalue)
+  // rvalues are not allocated, containers are created only when values are bound to names
+  // methods are defined in the header to be inlined in operations
+  class ExpressionResult {
+    private:
+      Container* container;
+      TaggedValue value;
+
+    public:
+      // null rvalue by default
+      ExpressionResult(): container(NULL), value() {}
+
+      static ExpressionResult fromContainer(Container* container) {
+        ExpressionResult result;
+        result.container = container;
+        return result;
+      }
+      static ExpressionResult fromValue(TaggedValue value) {
+        ExpressionResult result;
+        result.value = value;
+        return result;
+      }
+
+      // only references can be assigned
+      bool isReference() const {
+        return this->container != NULL;
+      }
+      Container* getContainer() const {
+        return this->container;
+      }
+
+      TaggedValue getValue() const {
+        if (this->container != NULL) return this->container->getValue();
+        return this->value;
+      }
+  };
+}
@@ -0,0 +1,96 @@
+#include "runtime/shapes.h"
+#include "shared/classes.h"
+
+#include <utility>
+
+namespace Runtime {
+  bool isShapeKey(TaggedValue key) {
+    if (!key.isPointer()) return true;
+    if (key.getType() != DataType::String) return false;
+
+    return Shared::Classes::cast<Value, StringValue>(key.getPointer())->getIsInterned();
+  }
+
+  FieldDescriptor::FieldDescriptor(FieldAccess access, FieldType type, FieldMutability mutability, ClassValue* classOwner, TaggedValue key) {
+    this->access = access;
+    this->type = type;
+    this->mutability = mutability;
+    this->classOwner = classOwner;
+    this->key = key;
+  }
+  FieldAccess FieldDescriptor::getAccess() const {
+    return this->access;
+  }
+  FieldType FieldDescriptor::getType() const {
+    return this->type;
+  }
+  FieldMutability FieldDescriptor::getMutability() const {
+    return this->mutability;
+  }
+  ClassValue* FieldDescriptor::getClassOwner() const {
+    return this->classOwner;
+  }
+  TaggedValue FieldDescriptor::getKey() const {
+    return this->key;
+  }
+  bool FieldDescriptor::isSame(const FieldDescriptor& other) const {
+    return (
+      this->key.isSame(other.key) &&
+      this->access == other.access &&
+      this->type == other.type &&
+      this->mutability == other.mutability &&
+      this->classOwner == other.classOwner
+    );
+  }
+
+  Shape::Shape() {
+    this->parent = NULL;
+  }
+  Shape::Shape(Shape* parent, std::vector<FieldDescriptor> descriptors) {
+    this->parent = parent;
+    this->descriptors = std::move(descriptors);
+  }
+  Shape::~Shape() {
+    for (int i = 0; i < this->transitions.size(); i++) {
+      delete this->transitions[i];
+    }
+  }
+  Shape* Shape::getParent() {
+    return this->parent;
+  }
+  int Shape::getSlotsAmount() {
+    return this->descriptors.size();
+  }
+  const std::vector<FieldDescriptor>& Shape::getDescriptors() {
+    return this->descriptors;
+  }
+  const FieldDescriptor& Shape::getDescriptor(int slot) {
+    return this->descriptors[slot];
+  }
+  int Shape::findSlot(TaggedValue key) {
+    // interned keys are found by pointer
+    for (int i = 0; i < this->descriptors.size(); i++) {
+      if (this->descriptors[i].getKey().isSame(key)) return i;
+    }
+
+    // other keys are compared by value
+    for (int i = 0; i < this->descriptors.size(); i++) {
+      if (compareValues(this->descriptors[i].getKey(), key)) return i;
+    }
+
+    return SHAPE_SLOT_NOT_FOUND;
+  }
+  Shape* Shape::addTransition(const FieldDescriptor& descriptor) {
+    for (int i = 0; i < this->transitions.size(); i++) {
+      if (this->transitions[i]->descriptors.back().isSame(descriptor)) return this->transitions[i];
+    }
+
+    std::vector<FieldDescriptor> descriptors = this->descriptors;
+    descriptors.push_back(descriptor);
+
+    Shape* child = new Shape(this, std::move(descriptors));
+    this->transitions.push_back(child);
+
+    return child;
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "runtime/tagged.h"
+#include "runtime/types.h"
+
+#include <vector>
+
+namespace Runtime {
+  // returned by shape lookup if key is not found
+  inline const int SHAPE_SLOT_NOT_FOUND = -1;
+
+  // returns if key can be held by shapes (immediate values and interned strings)
+  // other keys are owned by objects in dictionary mode
+  bool isShapeKey(TaggedValue key);
+
+  // metadata of object entry
+  // is shared by all objects of a shape, the object itself is the owner of the entry
+  class FieldDescriptor {
+    private:
+      FieldAccess access;
+      FieldType type;
+      FieldMutability mutability;
+
+      ClassValue* classOwner;
+
+      TaggedValue key;
+
+    public:
+      FieldDescriptor(FieldAccess access, FieldType type, FieldMutability mutability, ClassValue* classOwner, TaggedValue key);
+
+      FieldAccess getAccess() const;
+      FieldType getType() const;
+      FieldMutability getMutability() const;
+
+      ClassValue* getClassOwner() const;
+
+      TaggedValue getKey() const;
+
+      // descriptors are equal if keys are the same values and metadata matches
+      bool isSame(const FieldDescriptor&) const;
+  };
+
+  // hidden class of objects
+  // shape maps keys to slots of object values, slot of entry is its index in the shape
+  // shapes form a transition tree: adding an entry moves object to the child shape
+  // objects that get the same entries in the same order share one shape
+  // pointer keys are not retained by shapes, they have to be interned (permanent)
+  class Shape {
+    private:
+      Shape* parent;
+      std::vector<FieldDescriptor> descriptors;
+
+      // child shapes are owned by parent
+      std::vector<Shape*> transitions;
+
+      Shape(Shape* parent, std::vector<FieldDescriptor> descriptors);
+
+    public:
+      // creates root (empty) shape
+      Shape();
+      ~Shape();
+
+      Shape(const Shape&) = delete;
+      Shape& operator=(const Shape&) = delete;
+
+      Shape* getParent();
+      int getSlotsAmount();
+
+      const std::vector<FieldDescriptor>& getDescriptors();
+      const FieldDescriptor& getDescriptor(int slot);
+
+      // returns slot of entry with given key or SHAPE_SLOT_NOT_FOUND
+      int findSlot(TaggedValue key);
+
+      // returns child shape with added entry
+      // transition is created once and reused by other objects
+      Shape* addTransition(const FieldDescriptor&);
+  };
+}
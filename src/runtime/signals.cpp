@@ -13,11 +13,11 @@ namespace Runtime {
     this->cause = cause;
   }
 
-  ReturnSignal::ReturnSignal(AST::Statement* cause, Value* value) {
+  ReturnSignal::ReturnSignal(AST::Statement* cause, TaggedValue value) {
     this->cause = cause;
     this->value = value;
   }
-  Value* ReturnSignal::getValue() {
+  TaggedValue ReturnSignal::getValue() {
     return this->value;
   }
 }
@@ -31,10 +31,10 @@ namespace Runtime {
   // return signal
   class ReturnSignal: public Signal {
     private:
-      Value* value;
+      TaggedValue value;
 
     public:
-      ReturnSignal(AST::Statement*, Value*);
-      Value* getValue();
+      ReturnSignal(AST::Statement*, TaggedValue);
+      TaggedValue getValue();
   };
 }
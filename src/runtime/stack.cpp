@@ -2,7 +2,7 @@
 #include "runtime/types.h"
 
 namespace Runtime {
-  Container::Container(std::string name, Value* value, bool isConstant) {
+  Container::Container(std::string name, TaggedValue value, bool isConstant) {
     this->isConstant = isConstant;
     this->name = name;
     this->value = value;
@@ -13,100 +13,77 @@ namespace Runtime {
   std::string Container::getName() {
     return this->name;
   }
-  Value* Container::getValue() {
+  void Container::setName(std::string name) {
+    this->name = name;
+  }
+  TaggedValue Container::getValue() {
     return this->value;
   }
-  void Container::setValue(Value* value) {
+  void Container::setValue(TaggedValue value) {
     this->value = value;
   }
 
-  Scope::Scope() {
-    this->containers = {};
+  Scope::Scope(int base) {
+    this->base = base;
   }
-  bool Scope::addContainer(Container* container) {
-    if (this->isContainerAdded(container->getName())) return false;
-
-    this->containers.push_back(container);
-    return true;
-  }
-  bool Scope::isContainerAdded(std::string name) {
-    for (int i = 0; i < this->containers.size(); i++) {
-      if (this->containers[i]->getName() == name) {
-        return true;
-      }
-    }
-
-    return false;
-  }
-  std::vector<Container*> Scope::getContainers() {
-    return this->containers;
-  }
-  Container* Scope::getContainerByName(std::string name) {
-    for (int i = 0; i < this->containers.size(); i++) {
-      if (this->containers[i]->getName() == name) {
-        return this->containers[i];
-      }
-    }
-
-    return NULL;
-  }
-  bool Scope::removeContainerByName(std::string name) {
-    std::vector<Container*> updatedContainers = {};
-    bool isDeletingContainerFound = false;
-
-    for (int i = 0; i < this->containers.size(); i++) {
-      if (this->containers[i]->getName() == name) {
-        isDeletingContainerFound = true;
-      } else {
-        updatedContainers.push_back(this->containers[i]);
-      }
-    }
-
-    this->containers = updatedContainers;
-    return isDeletingContainerFound;
+  int Scope::getBase() {
+    return this->base;
   }
 
   Stack::Stack() {
+    this->slots = {};
     this->scopes = {};
+
+    this->slots.reserve(STACK_INITIAL_SLOTS_CAPACITY);
+    this->scopes.reserve(STACK_INITIAL_SCOPES_CAPACITY);
   }
   Stack::Stack(const Stack& stack) {
+    this->slots = stack.slots;
     this->scopes = stack.scopes;
   }
-  void Stack::addScope(Scope scope) {
-    this->scopes.push_back(scope);
+  void Stack::addScope() {
+    this->scopes.push_back(Scope(this->slots.size()));
   }
   void Stack::removeScope() {
+    this->slots.resize(this->getCurrentScopeBase());
     this->scopes.pop_back();
   }
   bool Stack::addContainer(Container* container) {
     if (this->scopes.size() == 0) return false;
-    return this->scopes[this->scopes.size() - 1].addContainer(container);
-  }
-  std::vector<Container*> Stack::getContainers() {
-    std::vector<Container*> containers = {};
 
-    for (int i = 0; i < this->scopes.size(); i++) {
-      for (int j = 0; j < this->scopes[i].getContainers().size(); j++) {
-        containers.push_back(this->scopes[i].getContainers()[j]);
-      }
+    // check the name is not used in current scope
+    std::string name = container->getName();
+    for (int i = this->getCurrentScopeBase(); i < this->slots.size() && name.size(); i++) {
+      if (this->slots[i]->getName() == name) return false;
     }
 
-    return containers;
+    this->slots.push_back(container);
+    return true;
+  }
+  const std::vector<Container*>& Stack::getContainers() {
+    return this->slots;
   }
-  std::vector<Container*> Stack::getContainersFromCurrentScope() {
-    if (this->scopes.size() == 0) return {};
-    return this->scopes[this->scopes.size() - 1].getContainers();
+  int Stack::getCurrentScopeBase() {
+    if (this->scopes.size() == 0) return this->slots.size();
+    return this->scopes[this->scopes.size() - 1].getBase();
   }
   Container* Stack::getContainerByName(std::string name) {
-    for (int i = this->scopes.size() - 1; i >= 0; i--) {
-      Container* container = this->scopes[i].getContainerByName(name);
-      if (container != NULL) return container;
+    // inner scopes are at the end of slots, so search from the top
+    for (int i = this->slots.size() - 1; i >= 0; i--) {
+      if (this->slots[i]->getName() == name) return this->slots[i];
     }
 
     return NULL;
   }
   bool Stack::removeContainerByName(std::string name) {
-    return this->scopes[this->scopes.size() - 1].removeContainerByName(name);
+    for (int i = this->slots.size() - 1; i >= this->getCurrentScopeBase(); i--) {
+      if (this->slots[i]->getName() == name) {
+        this->slots.erase(this->slots.begin() + i);
+        return true;
+      }
+    }
+
+    return false;
   }
   int Stack::getSize() {
     return this->scopes.size();
@@ -120,7 +97,7 @@ namespace Runtime {
     this->containers.push_back(container);
     return true;
   }
-  std::vector<Container*> ExportsRegistry::getContainers() {
+  const std::vector<Container*>& ExportsRegistry::getContainers() {
     return this->containers;
   }
   Container* ExportsRegistry::getContainerByName(std::string name) {
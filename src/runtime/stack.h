@@ -1,74 +1,74 @@
 #pragma once 
 
+#include "runtime/references.h"
+#include "runtime/tagged.h"
+
 #include <string>
 #include <vector>
 
 namespace Runtime {
-  // forward declaration (from types.h)
-  class Value;
+  // initial capacities of stack structures
+  // stack grows by doubling, so scope entry and exit do not allocate in steady state
+  inline const int STACK_INITIAL_SLOTS_CAPACITY = 64;
+  inline const int STACK_INITIAL_SCOPES_CAPACITY = 16;
 
   // container describes a variable
-  // containers are stored in memory pool
-  class Container {
+  // container is reference counted and holds a reference to its value while it is retained
+  class Container: public ReferenceCounted {
     private:
       bool isConstant;
       std::string name;
-      Value* value;
+      TaggedValue value;
 
     public:
-      Container(std::string, Value*, bool = false);
+      Container(std::string, TaggedValue, bool = false);
 
       bool getIsConstant();
       std::string getName();
+      // binds anonymous container to a name
+      void setName(std::string);
 
-      Value* getValue();
-      void setValue(Value*);
+      TaggedValue getValue();
+      void setValue(TaggedValue);
   };
 
-  // describes execution scope
+  // describes execution scope (block scope or function frame)
+  // scope is a range of stack slots: it starts at base index and ends at the base of the next scope
   // scopes are stored in stacks and are copied by value
   class Scope {
     private:
-      std::vector<Container*> containers;
+      int base;
 
     public:
-      Scope();
-
-      // returns flag if the container is added successfully
-      bool addContainer(Container*);
-
-      bool isContainerAdded(std::string);
+      Scope(int base);
 
-      // returns all containers in current scope
-      std::vector<Container*> getContainers();
-
-      // returns NULL if no container is found
-      Container* getContainerByName(std::string);
- 
-      // returns flag if the container is removed successfully
-      bool removeContainerByName(std::string);
+      int getBase();
   };
 
   // describes stack for executing module
+  // containers of all scopes are stored in one contiguous slots array
   class Stack {
     private: 
+      std::vector<Container*> slots;
       std::vector<Scope> scopes;
 
     public:
       Stack();
       Stack(const Stack&);
 
-      void addScope(Scope);
+      // scope entry and exit only move the scope bounds
+      void addScope();
       void removeScope();
       
       // returns flag if the container is added successfully
+      // anonymous containers (empty name) are never resolved by name, so they are always added
       bool addContainer(Container*);
 
-      // get all stack containers
-      std::vector<Container*> getContainers();
+      // get all stack containers (slots of all scopes)
+      const std::vector<Container*>& getContainers();
 
-      // returns containers from upper scope
-      std::vector<Container*> getContainersFromCurrentScope();
+      // returns index of the first slot of current scope
+      int getCurrentScopeBase();
 
       // returns NULL if no container is found
       Container* getContainerByName(std::string);
@@ -88,7 +88,7 @@ namespace Runtime {
       ExportsRegistry();
 
       bool addContainer(Container*);
-      std::vector<Container*> getContainers();
+      const std::vector<Container*>& getContainers();
       Container* getContainerByName(std::string);
   };
 }
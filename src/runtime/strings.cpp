@@ -0,0 +1,184 @@
+#include "runtime/strings.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace Runtime {
+  StringRope::StringRope(std::string chunk) {
+    this->type = StringRopeType::Leaf;
+    this->chunk = std::move(chunk);
+    this->left = nullptr;
+    this->right = nullptr;
+    this->parent = nullptr;
+    this->offset = 0;
+    this->length = this->chunk.size();
+    this->depth = 0;
+    this->hash = 0;
+    this->isHashed = false;
+  }
+  StringRope::StringRope(std::shared_ptr<StringRope> left, std::shared_ptr<StringRope> right) {
+    this->type = StringRopeType::Concatenation;
+    this->chunk = "";
+    this->parent = nullptr;
+    this->offset = 0;
+    this->length = left->getLength() + right->getLength();
+    this->depth = std::max(left->getDepth(), right->getDepth()) + 1;
+    this->hash = 0;
+    this->isHashed = false;
+    this->left = std::move(left);
+    this->right = std::move(right);
+  }
+  StringRope::StringRope(std::shared_ptr<StringRope> parent, size_t offset, size_t length) {
+    this->type = StringRopeType::Slice;
+    this->chunk = "";
+    this->left = nullptr;
+    this->right = nullptr;
+    this->parent = std::move(parent);
+    this->offset = offset;
+    this->length = length;
+    this->depth = 0;
+    this->hash = 0;
+    this->isHashed = false;
+  }
+
+  StringRopeType StringRope::getType() {
+    return this->type;
+  }
+  bool StringRope::isLeaf() {
+    return this->type == StringRopeType::Leaf;
+  }
+  bool StringRope::isFlat() {
+    return this->type != StringRopeType::Concatenation;
+  }
+
+  size_t StringRope::getLength() {
+    return this->length;
+  }
+  int StringRope::getDepth() {
+    return this->depth;
+  }
+
+  std::string_view StringRope::getChunk() {
+    if (this->type == StringRopeType::Slice) {
+      return std::string_view(this->parent->chunk).substr(this->offset, this->length);
+    }
+
+    return this->chunk;
+  }
+  size_t StringRope::getChunkHash() {
+    if (!this->isHashed) {
+      this->hash = std::hash<std::string_view>()(this->getChunk());
+      this->isHashed = true;
+    }
+
+    return this->hash;
+  }
+  bool StringRope::getIsHashed() {
+    return this->isHashed;
+  }
+  void StringRope::appendToChunk(std::string_view data) {
+    this->chunk += data;
+    this->length = this->chunk.size();
+    this->isHashed = false;
+  }
+
+  std::string StringRope::flatten() {
+    if (this->isFlat()) return std::string(this->getChunk());
+
+    std::string result;
+    result.reserve(this->length);
+
+    // nodes are visited from left to right
+    std::vector<StringRope*> nodes = { this };
+    while (nodes.size()) {
+      StringRope* node = nodes.back();
+      nodes.pop_back();
+
+      if (node->isFlat()) {
+        result += node->getChunk();
+        continue;
+      }
+
+      nodes.push_back(node->right.get());
+      nodes.push_back(node->left.get());
+    }
+
+    return result;
+  }
+
+  std::shared_ptr<StringRope> StringRope::concatenate(std::shared_ptr<StringRope> left, std::shared_ptr<StringRope> right) {
+    if (right->getLength() == 0) return left;
+    if (left->getLength() == 0) return right;
+
+    // short strings are cheaper to copy than to link
+    if (left->getLength() + right->getLength() < STRING_ROPE_MINIMUM_LENGTH) {
+      return std::make_shared<StringRope>(left->flatten() + right->flatten());
+    }
+
+    // short tail is merged with the last chunk of the left rope
+    if (!left->isFlat() && left->right->isFlat() && right->isFlat() && left->right->getLength() + right->getLength() < STRING_ROPE_CHUNK_LENGTH) {
+      std::shared_ptr<StringRope> tail = std::make_shared<StringRope>(left->right->flatten() + right->flatten());
+      return std::make_shared<StringRope>(left->left, tail);
+    }
+
+    return StringRope::join(std::move(left), std::move(right));
+  }
+  std::shared_ptr<StringRope> StringRope::join(std::shared_ptr<StringRope> left, std::shared_ptr<StringRope> right) {
+    if (left->getDepth() > right->getDepth() + 1) return StringRope::joinRight(std::move(left), std::move(right));
+    if (right->getDepth() > left->getDepth() + 1) return StringRope::joinLeft(std::move(left), std::move(right));
+
+    return std::make_shared<StringRope>(std::move(left), std::move(right));
+  }
+  std::shared_ptr<StringRope> StringRope::joinRight(std::shared_ptr<StringRope> left, std::shared_ptr<StringRope> right) {
+    // left is deeper, so it is a concatenation
+    std::shared_ptr<StringRope> subrope = left->right->getDepth() <= right->getDepth() + 1
+      ? std::make_shared<StringRope>(left->right, std::move(right))
+      : StringRope::joinRight(left->right, std::move(right));
+
+    if (subrope->getDepth() <= left->left->getDepth() + 1) {
+      return std::make_shared<StringRope>(left->left, std::move(subrope));
+    }
+
+    // new subrope is two levels deeper than its sibling
+    if (subrope->left->getDepth() > subrope->right->getDepth()) subrope = StringRope::rotateRight(std::move(subrope));
+    return StringRope::rotateLeft(std::make_shared<StringRope>(left->left, std::move(subrope)));
+  }
+  std::shared_ptr<StringRope> StringRope::joinLeft(std::shared_ptr<StringRope> left, std::shared_ptr<StringRope> right) {
+    // right is deeper, so it is a concatenation
+    std::shared_ptr<StringRope> subrope = right->left->getDepth() <= left->getDepth() + 1
+      ? std::make_shared<StringRope>(std::move(left), right->left)
+      : StringRope::joinLeft(std::move(left), right->left);
+
+    if (subrope->getDepth() <= right->right->getDepth() + 1) {
+      return std::make_shared<StringRope>(std::move(subrope), right->right);
+    }
+
+    // new subrope is two levels deeper than its sibling
+    if (subrope->right->getDepth() > subrope->left->getDepth()) subrope = StringRope::rotateLeft(std::move(subrope));
+    return StringRope::rotateRight(std::make_shared<StringRope>(std::move(subrope), right->right));
+  }
+  std::shared_ptr<StringRope> StringRope::rotateLeft(std::shared_ptr<StringRope> rope) {
+    std::shared_ptr<StringRope> pivot = rope->right;
+    return std::make_shared<StringRope>(std::make_shared<StringRope>(rope->left, pivot->left), pivot->right);
+  }
+  std::shared_ptr<StringRope> StringRope::rotateRight(std::shared_ptr<StringRope> rope) {
+    std::shared_ptr<StringRope> pivot = rope->left;
+    return std::make_shared<StringRope>(pivot->left, std::make_shared<StringRope>(pivot->right, rope->right));
+  }
+  std::shared_ptr<StringRope> StringRope::slice(std::shared_ptr<StringRope> rope, size_t offset, size_t length) {
+    if (offset == 0 && length == rope->getLength()) return rope;
+
+    // short slices are cheaper to copy than to pin the parent
+    if (length < STRING_SLICE_MINIMUM_LENGTH) {
+      return std::make_shared<StringRope>(std::string(rope->getChunk().substr(offset, length)));
+    }
+
+    // slices always refer to leaves
+    if (rope->getType() == StringRopeType::Slice) {
+      return std::make_shared<StringRope>(rope->parent, rope->offset + offset, length);
+    }
+
+    return std::make_shared<StringRope>(rope, offset, length);
+  }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Runtime {
+  // concatenations shorter than this are copied into one chunk
+  inline const size_t STRING_ROPE_MINIMUM_LENGTH = 256;
+  // short chunks appended to short chunks are merged to keep ropes shallow
+  inline const size_t STRING_ROPE_CHUNK_LENGTH = 256;
+  // slices shorter than this are copied instead of pinning the parent chunk
+  inline const size_t STRING_SLICE_MINIMUM_LENGTH = 64;
+
+  enum class StringRopeType {
+    // owns chunk of characters
+    Leaf,
+    // links two subropes
+    Concatenation,
+    // views a range of parent leaf
+    Slice,
+  };
+
+  // node of string rope
+  // nodes are immutable and are shared between strings
+  // ropes are balanced as AVL trees: depths of subropes differ by one at most
+  class StringRope {
+    private:
+      StringRopeType type;
+
+      // is set only for leaves
+      std::string chunk;
+
+      // are set only for concatenation nodes
+      std::shared_ptr<StringRope> left;
+      std::shared_ptr<StringRope> right;
+
+      // are set only for slices
+      std::shared_ptr<StringRope> parent;
+      size_t offset;
+
+      size_t length;
+      int depth;
+
+      // hash of flat characters is computed on the first request
+      size_t hash;
+      bool isHashed;
+
+      // links balanced ropes of any depths, new nodes are created on the path only
+      static std::shared_ptr<StringRope> join(std::shared_ptr<StringRope>, std::shared_ptr<StringRope>);
+      // attach the shallow rope to the spine of the deeper one
+      static std::shared_ptr<StringRope> joinRight(std::shared_ptr<StringRope>, std::shared_ptr<StringRope>);
+      static std::shared_ptr<StringRope> joinLeft(std::shared_ptr<StringRope>, std::shared_ptr<StringRope>);
+      static std::shared_ptr<StringRope> rotateLeft(std::shared_ptr<StringRope>);
+      static std::shared_ptr<StringRope> rotateRight(std::shared_ptr<StringRope>);
+
+    public:
+      StringRope(std::string chunk);
+      StringRope(std::shared_ptr<StringRope> left, std::shared_ptr<StringRope> right);
+      StringRope(std::shared_ptr<StringRope> parent, size_t offset, size_t length);
+
+      StringRopeType getType();
+      bool isLeaf();
+      // leaves and slices have contiguous characters
+      bool isFlat();
+
+      size_t getLength();
+      int getDepth();
+
+      // are valid only for flat nodes
+      std::string_view getChunk();
+      size_t getChunkHash();
+      bool getIsHashed();
+      // leaf that is not shared can be extended in place
+      void appendToChunk(std::string_view);
+
+      // copies all characters to one string (without recursion)
+      std::string flatten();
+
+      // concatenates ropes without copying characters of long strings
+      // result is balanced, so it takes O(log n) node allocations for ropes of n chunks
+      static std::shared_ptr<StringRope> concatenate(std::shared_ptr<StringRope>, std::shared_ptr<StringRope>);
+      // views range of flat rope without copying characters of long slices
+      static std::shared_ptr<StringRope> slice(std::shared_ptr<StringRope>, size_t offset, size_t length);
+  };
+}
@@ -0,0 +1,107 @@
+#include "runtime/tables.h"
+#include "runtime/types.h"
+
+#include <utility>
+
+namespace Runtime {
+  HashTable::HashTable() {
+    this->size = 0;
+  }
+  size_t HashTable::getMask() const {
+    return this->entries.size() - 1;
+  }
+  int HashTable::getSize() const {
+    return this->size;
+  }
+  int HashTable::getCapacity() const {
+    return this->entries.size();
+  }
+  const std::vector<HashTableEntry>& HashTable::getEntries() const {
+    return this->entries;
+  }
+  int HashTable::findIndex(TaggedValue key, size_t hash) {
+    if (this->entries.empty()) return -1;
+
+    size_t index = hash & this->getMask();
+
+    for (int distance = 0; ; distance++) {
+      const HashTableEntry& entry = this->entries[index];
+
+      // entry of the key would have taken this slot
+      if (entry.isEmpty() || entry.distance < distance) return -1;
+      if (entry.hash == hash && compareValues(entry.key, key)) return index;
+
+      index = (index + 1) & this->getMask();
+    }
+  }
+  TaggedValue* HashTable::find(TaggedValue key) {
+    int index = this->findIndex(key, hashValue(key));
+    if (index < 0) return NULL;
+
+    return &this->entries[index].value;
+  }
+  bool HashTable::has(TaggedValue key) {
+    return this->findIndex(key, hashValue(key)) >= 0;
+  }
+  void HashTable::place(HashTableEntry entry) {
+    size_t index = entry.hash & this->getMask();
+    entry.distance = 0;
+
+    while (true) {
+      HashTableEntry& current = this->entries[index];
+
+      if (current.isEmpty()) {
+        current = entry;
+        return;
+      }
+
+      // entry that is further from home takes the slot
+      if (current.distance < entry.distance) std::swap(current, entry);
+
+      index = (index + 1) & this->getMask();
+      entry.distance++;
+    }
+  }
+  void HashTable::grow() {
+    int capacity = this->entries.empty() ? HASH_TABLE_MINIMUM_CAPACITY : this->entries.size() * 2;
+
+    std::vector<HashTableEntry> previousEntries = std::move(this->entries);
+    this->entries = std::vector<HashTableEntry>(capacity, { TaggedValue(), TaggedValue(), 0, HASH_TABLE_EMPTY_DISTANCE });
+
+    for (int i = 0; i < previousEntries.size(); i++) {
+      if (!previousEntries[i].isEmpty()) this->place(previousEntries[i]);
+    }
+  }
+  void HashTable::insert(TaggedValue key, TaggedValue value) {
+    if ((this->size + 1) * HASH_TABLE_LOAD_DENOMINATOR > this->getCapacity() * HASH_TABLE_LOAD_NUMERATOR) {
+      this->grow();
+    }
+
+    this->place({ key, value, hashValue(key), 0 });
+    this->size++;
+  }
+  bool HashTable::remove(TaggedValue key, TaggedValue& removedKey, TaggedValue& removedValue) {
+    int index = this->findIndex(key, hashValue(key));
+    if (index < 0) return false;
+
+    removedKey = this->entries[index].key;
+    removedValue = this->entries[index].value;
+
+    // following entries are shifted back until an entry is at its home slot
+    size_t current = index;
+    size_t next = (current + 1) & this->getMask();
+
+    while (!this->entries[next].isEmpty() && this->entries[next].distance > 0) {
+      this->entries[current] = this->entries[next];
+      this->entries[current].distance--;
+
+      current = next;
+      next = (next + 1) & this->getMask();
+    }
+
+    this->entries[current] = { TaggedValue(), TaggedValue(), 0, HASH_TABLE_EMPTY_DISTANCE };
+    this->size--;
+
+    return true;
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "runtime/tagged.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Runtime {
+  // capacity of table is a power of two, so the hash is reduced by mask
+  inline const int HASH_TABLE_MINIMUM_CAPACITY = 8;
+  // table grows when it is more than 7/8 full
+  inline const int HASH_TABLE_LOAD_NUMERATOR = 7;
+  inline const int HASH_TABLE_LOAD_DENOMINATOR = 8;
+  // distance of empty entry
+  inline const int HASH_TABLE_EMPTY_DISTANCE = -1;
+
+  // entry stores full hash, so hashes are not recomputed on growth and most mismatches skip comparison
+  // distance is how far the entry is from its home slot
+  struct HashTableEntry {
+    TaggedValue key;
+    TaggedValue value;
+    size_t hash;
+    int distance;
+
+    bool isEmpty() const {
+      return this->distance == HASH_TABLE_EMPTY_DISTANCE;
+    }
+  };
+
+  // open-addressing hash table of values (Robin Hood hashing)
+  // entries are stored inline in one array, lookup probes neighbouring slots
+  // entry that is further from home slot takes the slot, so probe sequences stay short
+  // removal shifts the following entries back instead of leaving tombstones
+  // keys are compared by compareValues, table does not retain keys and values
+  class HashTable {
+    private:
+      std::vector<HashTableEntry> entries;
+      int size;
+
+      size_t getMask() const;
+      // returns index of entry with given key or -1
+      int findIndex(TaggedValue key, size_t hash);
+      // places entry without checking for existing key
+      void place(HashTableEntry);
+      void grow();
+
+    public:
+      HashTable();
+
+      int getSize() const;
+      int getCapacity() const;
+
+      // entries are iterated by slots, empty entries have to be skipped
+      const std::vector<HashTableEntry>& getEntries() const;
+
+      // returns pointer to value of entry or NULL if key is not found
+      // pointer is valid until table is modified
+      TaggedValue* find(TaggedValue key);
+      bool has(TaggedValue key);
+
+      // adds entry, key has to be absent
+      void insert(TaggedValue key, TaggedValue value);
+      // returns if entry is removed, removed key and value are written to output arguments
+      bool remove(TaggedValue key, TaggedValue& removedKey, TaggedValue& removedValue);
+  };
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace Runtime {
+  // define all possible data types
+  enum class DataType {
+    Null,
+    Boolean,
+    Number,
+    String,
+
+    Vector,
+    Object,
+    Map,
+    Set,
+    Float64Array,
+    Int64Array,
+
+    Function,
+    Class,
+  };
+
+  // forward declaration (from types.h)
+  class Value;
+
+  // NaN-boxing layout
+  // numbers are stored as doubles, all the other data is stored in quiet NaN space
+  inline const uint64_t TAGGED_QUIET_NAN = 0x7ffc000000000000;
+  inline const uint64_t TAGGED_SIGN_BIT = 0x8000000000000000;
+  // pointers use sign bit and 48 bits of payload
+  inline const uint64_t TAGGED_POINTER = TAGGED_SIGN_BIT | TAGGED_QUIET_NAN;
+  // immediates use the lowest bits of payload
+  inline const uint64_t TAGGED_NULL = TAGGED_QUIET_NAN | 1;
+  inline const uint64_t TAGGED_FALSE = TAGGED_QUIET_NAN | 2;
+  inline const uint64_t TAGGED_TRUE = TAGGED_QUIET_NAN | 3;
+  // NaN produced by computations is stored as canonical NaN outside of tagged space
+  inline const uint64_t TAGGED_CANONICAL_NAN = 0x7ff8000000000000;
+
+  // 64-bit value handle
+  // null, booleans and numbers are stored inline and are never allocated
+  // strings and compound values are stored as pointers to heap values
+  // methods are defined in the header to be inlined in operations
+  class TaggedValue {
+    private:
+      uint64_t bits;
+
+      DataType getPointerType() const;
+
+    public:
+      // null by default
+      TaggedValue(): bits(TAGGED_NULL) {}
+
+      static TaggedValue fromBoolean(bool data) {
+        TaggedValue value;
+        value.bits = data ? TAGGED_TRUE : TAGGED_FALSE;
+        return value;
+      }
+      static TaggedValue fromNumber(double data) {
+        TaggedValue value;
+
+        if (data != data) {
+          value.bits = TAGGED_CANONICAL_NAN;
+        } else {
+          std::memcpy(&value.bits, &data, sizeof(double));
+        }
+
+        return value;
+      }
+      static TaggedValue fromPointer(Value* pointer) {
+        TaggedValue value;
+        value.bits = TAGGED_POINTER | (uint64_t)(uintptr_t)pointer;
+        return value;
+      }
+
+      bool isNull() const {
+        return this->bits == TAGGED_NULL;
+      }
+      bool isBoolean() const {
+        return (this->bits | 1) == TAGGED_TRUE;
+      }
+      bool isNumber() const {
+        return (this->bits & TAGGED_QUIET_NAN) != TAGGED_QUIET_NAN;
+      }
+      bool isPointer() const {
+        return (this->bits & TAGGED_POINTER) == TAGGED_POINTER;
+      }
+
+      bool getBoolean() const {
+        return this->bits == TAGGED_TRUE;
+      }
+      double getNumber() const {
+        double data;
+        std::memcpy(&data, &this->bits, sizeof(double));
+        return data;
+      }
+      Value* getPointer() const {
+        return (Value*)(uintptr_t)(this->bits & ~TAGGED_POINTER);
+      }
+
+      // immediates are typed by tag, pointers by heap value type
+      DataType getType() const {
+        if (this->isNumber()) return DataType::Number;
+        if (this->isPointer()) return this->getPointerType();
+        if (this->isNull()) return DataType::Null;
+        return DataType::Boolean;
+      }
+
+      // identity comparison (same bits)
+      bool isSame(TaggedValue other) const {
+        return this->bits == other.bits;
+      }
+  };
+}
@@ -1,92 +1,179 @@
+#include "runtime/shapes.h"
 #include "runtime/stack.h"
 #include "runtime/types.h"
 #include "shared/classes.h"
 
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
 namespace Runtime {
-  NullValue::NullValue() {}
-  DataType NullValue::getType() {
-    return DataType::Null;
+  DataType TaggedValue::getPointerType() const {
+    return this->getPointer()->getType();
   }
 
-  BooleanValue::BooleanValue(bool data) {
-    this->data = data;
-  }
-  BooleanValue::BooleanValue(const BooleanValue& other) {
-    this->data = other.data;
-  }
-  DataType BooleanValue::getType() {
-    return DataType::Boolean;
+  StringValue::StringValue(std::string data) {
+    this->rope = std::make_shared<StringRope>(std::move(data));
+    this->isInterned = false;
   }
-  bool BooleanValue::getData() {
-    return this->data;
+  StringValue::StringValue(std::shared_ptr<StringRope> rope) {
+    this->rope = std::move(rope);
+    this->isInterned = false;
   }
-  void BooleanValue::setData(bool data) {
-    this->data = data;
+  StringValue::StringValue(const StringValue& other) {
+    // chunks are immutable, so copies share them
+    this->rope = other.rope;
+    // copies are not registered in intern table
+    this->isInterned = false;
   }
-  bool BooleanValue::getDataOf(Value* value) {
-    return Shared::Classes::cast<Value, BooleanValue>(value)->getData();
+  DataType StringValue::getType() {
+    return DataType::String;
   }
+  std::string_view StringValue::getData() {
+    if (!this->rope->isFlat()) {
+      this->rope = std::make_shared<StringRope>(this->rope->flatten());
+    }
 
-  NumberValue::NumberValue(double data) {
-    this->data = data;
+    return this->rope->getChunk();
   }
-  NumberValue::NumberValue(const NumberValue& other) {
-    this->data = other.data;
+  void StringValue::setData(std::string data) {
+    this->rope = std::make_shared<StringRope>(std::move(data));
   }
-  DataType NumberValue::getType() {
-    return DataType::Number;
+  size_t StringValue::getLength() {
+    return this->rope->getLength();
   }
-  double NumberValue::getData() {
-    return this->data;
+  size_t StringValue::getHash() {
+    // chunk hash is valid only for flat strings
+    this->getData();
+    return this->rope->getChunkHash();
   }
-  void NumberValue::setData(double data) {
-    this->data = data;
+  bool StringValue::hasCachedHash() {
+    return this->rope->isFlat() && this->rope->getIsHashed();
   }
-  double NumberValue::getDataOf(Value* value) {
-    return Shared::Classes::cast<Value, NumberValue>(value)->getData();
+  std::shared_ptr<StringRope> StringValue::getSlice(size_t offset, size_t length) {
+    // slices are taken from flat ropes
+    this->getData();
+    return StringRope::slice(this->rope, offset, length);
   }
-
-  StringValue::StringValue(std::string data) {
-    this->data = data;
+  void StringValue::compact() {
+    if (this->rope->isLeaf()) return;
+    this->rope = std::make_shared<StringRope>(this->rope->flatten());
   }
-  StringValue::StringValue(const StringValue& other) {
-    this->data = other.data;
+  bool StringValue::getIsInterned() {
+    return this->isInterned;
   }
-  DataType StringValue::getType() {
-    return DataType::String;
+  void StringValue::setIsInterned(bool isInterned) {
+    this->isInterned = isInterned;
   }
-  std::string StringValue::getData() {
-    return this->data;
+  std::shared_ptr<StringRope> StringValue::getRope() {
+    return this->rope;
   }
-  void StringValue::setData(std::string data) {
-    this->data = data;
+  void StringValue::append(StringValue* other) {
+    // chunk that is not shared with other strings is extended in place
+    if (this->rope->isLeaf() && this->rope.use_count() == 1) {
+      this->rope->appendToChunk(other->getData());
+      return;
+    }
+
+    this->rope = StringRope::concatenate(this->rope, other->getRope());
   }
-  std::string StringValue::getDataOf(Value* value) {
-    return Shared::Classes::cast<Value, StringValue>(value)->getData();
+  std::string_view StringValue::getDataOf(TaggedValue value) {
+    return Shared::Classes::cast<Value, StringValue>(value.getPointer())->getData();
   }
 
-  VectorValue::VectorValue(std::vector<Value*> items) {
-    this->items = items;
+  VectorValue::VectorValue(std::vector<TaggedValue> items) {
+    this->kind = VectorKind::Numbers;
+
+    for (int i = 0; i < items.size(); i++) {
+      if (!items[i].isNumber()) this->kind = VectorKind::Generic;
+    }
+
+    if (this->kind == VectorKind::Generic) {
+      this->items = std::move(items);
+      return;
+    }
+
+    this->numbers.reserve(items.size());
+    for (int i = 0; i < items.size(); i++) {
+      this->numbers.push_back(items[i].getNumber());
+    }
   }
   DataType VectorValue::getType() {
     return DataType::Vector;
   }
-  std::vector<Value*> VectorValue::getItems() {
+  VectorKind VectorValue::getKind() {
+    return this->kind;
+  }
+  void VectorValue::convertToGeneric() {
+    this->items.reserve(this->numbers.capacity());
+
+    for (int i = 0; i < this->numbers.size(); i++) {
+      this->items.push_back(TaggedValue::fromNumber(this->numbers[i]));
+    }
+
+    this->numbers = {};
+    this->kind = VectorKind::Generic;
+  }
+  const std::vector<TaggedValue>& VectorValue::getItems() {
     return this->items;
   }
-  void VectorValue::setItem(int index, Value* value) {
+  const std::vector<double>& VectorValue::getNumbers() {
+    return this->numbers;
+  }
+  int VectorValue::getSize() {
+    if (this->kind == VectorKind::Numbers) return this->numbers.size();
+    return this->items.size();
+  }
+  TaggedValue VectorValue::getItem(int index) {
+    if (this->kind == VectorKind::Numbers) return TaggedValue::fromNumber(this->numbers[index]);
+    return this->items[index];
+  }
+  void VectorValue::setItem(int index, TaggedValue value) {
+    if (this->kind == VectorKind::Numbers && value.isNumber()) {
+      this->numbers[index] = value.getNumber();
+      return;
+    }
+
+    if (this->kind == VectorKind::Numbers) this->convertToGeneric();
     this->items[index] = value;
   }
-  void VectorValue::push(Value* value) {
+  void VectorValue::push(TaggedValue value) {
+    if (this->kind == VectorKind::Numbers && value.isNumber()) {
+      this->numbers.push_back(value.getNumber());
+      return;
+    }
+
+    if (this->kind == VectorKind::Numbers) this->convertToGeneric();
     this->items.push_back(value);
   }
-  Value* VectorValue::pop() {
-    Value* last = this->items[this->items.size() - 1];
+  TaggedValue VectorValue::pop() {
+    if (this->kind == VectorKind::Numbers) {
+      double last = this->numbers[this->numbers.size() - 1];
+      this->numbers.pop_back();
+      return TaggedValue::fromNumber(last);
+    }
+
+    TaggedValue last = this->items[this->items.size() - 1];
     this->items.pop_back();
     return last;
   }
+  void VectorValue::reserve(int capacity) {
+    if (this->kind == VectorKind::Numbers) {
+      this->numbers.reserve(capacity);
+      return;
+    }
 
-  Field::Field(FieldAccess access, FieldType type, FieldMutability mutability, ClassValue* classOwner, Value* objectOwner, Value* key, Value* value): key(key) {
+    this->items.reserve(capacity);
+  }
+  void VectorValue::append(const std::vector<TaggedValue>& items) {
+    this->reserve(this->getSize() + items.size());
+
+    for (int i = 0; i < items.size(); i++) {
+      this->push(items[i]);
+    }
+  }
+
+  Field::Field(FieldAccess access, FieldType type, FieldMutability mutability, ClassValue* classOwner, Value* objectOwner, TaggedValue key, TaggedValue value) {
     this->access = access;
     this->type = type;
     this->mutability = mutability;
@@ -95,34 +182,39 @@ namespace Runtime {
     this->key = key;
     this->value = value;
   }
-  FieldAccess Field::getAccess() {
+  FieldAccess Field::getAccess() const {
     return this->access;
   }
-  FieldType Field::getType() {
+  FieldType Field::getType() const {
     return this->type;
   }
-  FieldMutability Field::getMutability() {
+  FieldMutability Field::getMutability() const {
     return this->mutability;
   }
-  ClassValue* Field::getClassOwner() {
+  ClassValue* Field::getClassOwner() const {
     return this->classOwner;
   }
-  Value* Field::getObjectOwner() {
+  Value* Field::getObjectOwner() const {
     return this->objectOwner;
   }
-  Value* Field::getKey() {
+  TaggedValue Field::getKey() const {
     return this->key;
   }
-  Value* Field::getValue() {
+  TaggedValue Field::getValue() const {
     return this->value;
   }
-  void Field::setValue(Value* value) {
+  void Field::setValue(TaggedValue value) {
     this->value = value;
   }
 
-  ObjectValue::ObjectValue(ClassValue* constructor, std::vector<Field> entries) {
+  ObjectValue::ObjectValue(ClassValue* constructor, Shape* shape, std::vector<TaggedValue> values) {
     this->constructor = constructor;
-    this->entries = entries;
+    this->shape = shape;
+    this->values = std::move(values);
+    this->dictionary = NULL;
+  }
+  ObjectValue::~ObjectValue() {
+    delete this->dictionary;
   }
   DataType ObjectValue::getType() {
     return DataType::Object;
@@ -130,58 +222,240 @@ namespace Runtime {
   ClassValue* ObjectValue::getConstructor() {
     return this->constructor;
   }
-  std::vector<Field> ObjectValue::getEntries() {
-    return this->entries;
+  Shape* ObjectValue::getShape() {
+    return this->shape;
   }
-  Value* ObjectValue::getEntryValue(Value* key) {
-    for (int i = 0; i < this->entries.size(); i++) {
-      if (compareValues(key, this->entries[i].getKey())) {
-        return this->entries[i].getValue();
-      }
+  bool ObjectValue::getIsDictionary() {
+    return this->dictionary != NULL;
+  }
+  void ObjectValue::convertToDictionary() {
+    if (this->dictionary != NULL) return;
+
+    this->dictionary = new HashTable();
+    this->dictionaryDescriptors = this->shape->getDescriptors();
+
+    for (int i = 0; i < this->dictionaryDescriptors.size(); i++) {
+      this->dictionary->insert(this->dictionaryDescriptors[i].getKey(), TaggedValue::fromNumber(i));
     }
 
-    return NULL;
+    this->shape = NULL;
   }
-  bool ObjectValue::addField(Field field) {
-    if (this->hasEntry(field.getKey())) return false;
-    this->entries.push_back(field);
-    return true;
+  const std::vector<TaggedValue>& ObjectValue::getValues() {
+    return this->values;
   }
-  bool ObjectValue::setEntry(Value* key, Value* value) {
-    for (int i = 0; i < this->entries.size(); i++) {
-      if (compareValues(key, this->entries[i].getKey())) {
-        this->entries[i].setValue(value);
-        return true;
-      }
-    }
+  TaggedValue ObjectValue::getValue(int slot) {
+    return this->values[slot];
+  }
+  void ObjectValue::setValue(int slot, TaggedValue value) {
+    this->values[slot] = value;
+  }
+  int ObjectValue::findSlot(TaggedValue key) {
+    if (this->dictionary == NULL) return this->shape->findSlot(key);
 
-    return false;
+    TaggedValue* slot = this->dictionary->find(key);
+    if (slot == NULL) return SHAPE_SLOT_NOT_FOUND;
+
+    return slot->getNumber();
   }
-  bool ObjectValue::hasEntry(Value* key) {
-    for (int i = 0; i < this->entries.size(); i++) {
-      if (compareValues(key, this->entries[i].getKey())) {
-        return true;
-      }
+  const FieldDescriptor& ObjectValue::getDescriptor(int slot) {
+    if (this->dictionary == NULL) return this->shape->getDescriptor(slot);
+    return this->dictionaryDescriptors[slot];
+  }
+  TaggedValue ObjectValue::getEntryValue(TaggedValue key) {
+    int slot = this->findSlot(key);
+    if (slot == SHAPE_SLOT_NOT_FOUND) return TaggedValue();
+
+    return this->values[slot];
+  }
+  bool ObjectValue::addField(const FieldDescriptor& descriptor, TaggedValue value) {
+    if (this->hasEntry(descriptor.getKey())) return false;
+
+    // large objects would make long shape chains that are not shared
+    if (this->dictionary == NULL && this->values.size() >= OBJECT_DICTIONARY_THRESHOLD) this->convertToDictionary();
+    // shapes are shared and do not retain keys, so own keys are kept in dictionary
+    if (this->dictionary == NULL && !isShapeKey(descriptor.getKey())) this->convertToDictionary();
+
+    if (this->dictionary == NULL) {
+      this->shape = this->shape->addTransition(descriptor);
+    } else {
+      this->dictionary->insert(descriptor.getKey(), TaggedValue::fromNumber(this->values.size()));
+      this->dictionaryDescriptors.push_back(descriptor);
     }
 
-    return false;
+    this->values.push_back(value);
+    return true;
   }
+  bool ObjectValue::setEntry(TaggedValue key, TaggedValue value) {
+    int slot = this->findSlot(key);
+    if (slot == SHAPE_SLOT_NOT_FOUND) return false;
 
-  ClassValue::ClassValue(std::vector<ClassValue*> parents, std::vector<Field> fields, FunctionValue* constructor, FunctionValue* destructor): constructor(constructor), destructor(destructor) {
-    this->parents = parents;
-    this->fields = fields;
-    this->constructor = constructor;
-    this->destructor = destructor;
+    this->values[slot] = value;
+    return true;
+  }
+  bool ObjectValue::hasEntry(TaggedValue key) {
+    return this->findSlot(key) != SHAPE_SLOT_NOT_FOUND;
+  }
+
+  MapValue::MapValue() {}
+  DataType MapValue::getType() {
+    return DataType::Map;
+  }
+  HashTable& MapValue::getTable() {
+    return this->table;
+  }
+
+  SetValue::SetValue() {}
+  DataType SetValue::getType() {
+    return DataType::Set;
+  }
+  HashTable& SetValue::getTable() {
+    return this->table;
+  }
+
+  Float64ArrayValue::Float64ArrayValue(int size): items(size) {}
+  DataType Float64ArrayValue::getType() {
+    return DataType::Float64Array;
+  }
+  AlignedArray<double>& Float64ArrayValue::getItems() {
+    return this->items;
+  }
+
+  Int64ArrayValue::Int64ArrayValue(int size): items(size) {}
+  DataType Int64ArrayValue::getType() {
+    return DataType::Int64Array;
+  }
+  AlignedArray<int64_t>& Int64ArrayValue::getItems() {
+    return this->items;
+  }
+
+  // identity of the last created class
+  static uint64_t lastClassIdentity = 0;
+
+  ClassValue::ClassValue(std::vector<ClassValue*> parents, std::vector<ClassValue*> parentsLinearization, FunctionValue* constructor, FunctionValue* destructor): constructor(constructor), destructor(destructor) {
+    this->identity = ++lastClassIdentity;
+    this->parents = std::move(parents);
+
+    this->linearization.push_back(this);
+    this->linearization.insert(this->linearization.end(), parentsLinearization.begin(), parentsLinearization.end());
+
+    this->ancestors.insert(this->linearization.begin(), this->linearization.end());
   }
   DataType ClassValue::getType() {
     return DataType::Class;
   }
-  std::vector<ClassValue*> ClassValue::getParents() {
+  uint64_t ClassValue::getIdentity() {
+    return this->identity;
+  }
+  const std::vector<ClassValue*>& ClassValue::getParents() {
     return this->parents;
-  }  
-  std::vector<Field> ClassValue::getFields() {
+  }
+  const std::vector<Field>& ClassValue::getFields() {
     return this->fields;
   }
+  const std::vector<ClassValue*>& ClassValue::getLinearization() {
+    return this->linearization;
+  }
+  FunctionValue* ClassValue::getConstructor() {
+    return this->constructor;
+  }
+  FunctionValue* ClassValue::getDestructor() {
+    return this->destructor;
+  }
+  void ClassValue::setFields(std::vector<Field> ownFields) {
+    this->fields = {};
+    this->staticSlots = {};
+    this->instanceSlots = {};
+
+    // own fields go first, then own fields of ancestors by linearization order
+    // the first class in linearization defines the field
+    for (int i = 0; i < this->linearization.size(); i++) {
+      ClassValue* owner = this->linearization[i];
+      const std::vector<Field>& declaredFields = i == 0 ? ownFields : owner->fields;
+
+      for (int j = 0; j < declaredFields.size(); j++) {
+        const Field& field = declaredFields[j];
+
+        // fields inherited by ancestor are taken from their own classes
+        if (field.getClassOwner() != owner) continue;
+
+        std::unordered_map<Value*, int>& slots = field.getType() == FieldType::STATIC ? this->staticSlots : this->instanceSlots;
+        if (this->findSlot(slots, field.getType(), field.getKey()) != FIELD_SLOT_NOT_FOUND) continue;
+
+        this->fields.push_back(field);
+        if (field.getKey().isPointer()) slots[field.getKey().getPointer()] = this->fields.size() - 1;
+      }
+    }
+  }
+  int ClassValue::findSlot(const std::unordered_map<Value*, int>& slots, FieldType type, TaggedValue key) {
+    // interned keys are found by pointer
+    if (key.isPointer()) {
+      auto slot = slots.find(key.getPointer());
+      if (slot != slots.end()) return slot->second;
+    }
+
+    // other keys are compared by value
+    for (int i = 0; i < this->fields.size(); i++) {
+      if (this->fields[i].getType() == type && compareValues(this->fields[i].getKey(), key)) return i;
+    }
+
+    return FIELD_SLOT_NOT_FOUND;
+  }
+  int ClassValue::findStaticSlot(TaggedValue key) {
+    return this->findSlot(this->staticSlots, FieldType::STATIC, key);
+  }
+  int ClassValue::findInstanceSlot(TaggedValue key) {
+    return this->findSlot(this->instanceSlots, FieldType::INSTANCE, key);
+  }
+  bool ClassValue::hasAncestor(ClassValue* ancestor) {
+    return this->ancestors.count(ancestor) > 0;
+  }
+
+  std::optional<std::vector<ClassValue*>> linearizeParents(const std::vector<ClassValue*>& parents) {
+    // sequences to merge: linearizations of parents and the list of parents
+    std::vector<std::vector<ClassValue*>> sequences = {};
+    for (int i = 0; i < parents.size(); i++) {
+      sequences.push_back(parents[i]->getLinearization());
+    }
+    sequences.push_back(parents);
+
+    std::vector<ClassValue*> result = {};
+    // index of current head of each sequence
+    std::vector<int> heads(sequences.size(), 0);
+
+    while (true) {
+      ClassValue* candidate = NULL;
+
+      for (int i = 0; i < sequences.size() && candidate == NULL; i++) {
+        if (heads[i] >= sequences[i].size()) continue;
+        candidate = sequences[i][heads[i]];
+
+        // head is valid if it is not in the tail of any sequence
+        for (int j = 0; j < sequences.size(); j++) {
+          for (int k = heads[j] + 1; k < sequences[j].size(); k++) {
+            if (sequences[j][k] == candidate) {
+              candidate = NULL;
+              break;
+            }
+          }
+          if (candidate == NULL) break;
+        }
+      }
+
+      if (candidate == NULL) break;
+
+      result.push_back(candidate);
+      for (int i = 0; i < sequences.size(); i++) {
+        if (heads[i] < sequences[i].size() && sequences[i][heads[i]] == candidate) heads[i]++;
+      }
+    }
+
+    // all the sequences have to be merged
+    for (int i = 0; i < sequences.size(); i++) {
+      if (heads[i] < sequences[i].size()) return std::nullopt;
+    }
+
+    return result;
+  }
 
   FunctionArgumentsAmount::FunctionArgumentsAmount(int argumentsAmount, int optionalArguments) {
     this->argumentsAmount = argumentsAmount;
@@ -197,9 +471,30 @@ namespace Runtime {
     return this->optionalArguments;
   }
 
+  FunctionParameter::FunctionParameter(std::string name, AST::Expression* defaultValue) {
+    this->name = name;
+    this->defaultValue = defaultValue;
+  }
+  const std::string& FunctionParameter::getName() const {
+    return this->name;
+  }
+  AST::Expression* FunctionParameter::getDefaultValue() const {
+    return this->defaultValue;
+  }
+
+  FunctionValue::FunctionValue(Stack* stack, Value* context, AST::BlockStatement* body, std::vector<FunctionParameter> parameters, FunctionArgumentsAmount arguments) {
+    this->closure = stack;
+    this->context = context;
+    this->body = body;
+    this->parameters = parameters;
+    this->callable = NULL;
+    this->argumentsAmount = arguments;
+  }
   FunctionValue::FunctionValue(Stack* stack, Value* context, Callable callable, FunctionArgumentsAmount arguments) {
     this->closure = stack;
     this->context = context;
+    this->body = NULL;
+    this->parameters = {};
     this->callable = callable;
     this->argumentsAmount = arguments;
   }
@@ -215,76 +510,95 @@ namespace Runtime {
   Value* FunctionValue::getContext() {
     return this->context;
   }
-  Value* FunctionValue::execute(std::vector<Value*> values) {
-    return this->callable(values);
-  }
   FunctionArgumentsAmount FunctionValue::getArgumentsAmount() {
     return this->argumentsAmount;
   }
+  bool FunctionValue::isBuiltin() {
+    return this->body == NULL;
+  }
+  AST::BlockStatement* FunctionValue::getBody() {
+    return this->body;
+  }
+  const std::vector<FunctionParameter>& FunctionValue::getParameters() {
+    return this->parameters;
+  }
+  TaggedValue FunctionValue::execute(Memory& memory, std::vector<TaggedValue> values) {
+    return this->callable(memory, values);
+  }
  
-  bool compareValues(Value* value1, Value* value2) {
-    // check if it is the same value
-    if (value1 == value2) return true;
-    
-    // otherwise if one of values is not defined 
-    if (!value1 || !value2) return false;
-
-    // check if both are primitives
-    if (Shared::Classes::isInstanceOf<Value, PrimitiveValue>(value1) && Shared::Classes::isInstanceOf<Value, PrimitiveValue>(value2)) {
-      DataType type1 = value1->getType();
-      DataType type2 = value2->getType();
-
-      // check if the same type
-      if (type1 != type2) return false;
-      
-      // two nulls are the same
-      if (type1 == DataType::Null) return true;
-      if (type1 == DataType::Boolean) {
-        bool data1 = BooleanValue::getDataOf(value1);
-        bool data2 = BooleanValue::getDataOf(value2);
-        return data1 == data2;
-      }
-      if (type1 == DataType::Number) {
-        double data1 = NumberValue::getDataOf(value1);
-        double data2 = NumberValue::getDataOf(value2);
-        return data1 == data2;
-      }
-      if (type1 == DataType::String) {
-        std::string data1 = StringValue::getDataOf(value1);
-        std::string data2 = StringValue::getDataOf(value2);
-        return data1 == data2;
-      }
+  bool compareValues(TaggedValue value1, TaggedValue value2) {
+    // numbers are compared by value (NaN is not equal to itself)
+    if (value1.isNumber() || value2.isNumber()) {
+      return value1.isNumber() && value2.isNumber() && value1.getNumber() == value2.getNumber();
     }
 
-    // otherwise consider different
-    return false;
+    // check if it is the same value (null, booleans and references)
+    if (value1.isSame(value2)) return true;
+
+    // otherwise only strings are compared by value
+    if (!value1.isPointer() || !value2.isPointer()) return false;
+    if (value1.getType() != DataType::String || value2.getType() != DataType::String) return false;
+
+    StringValue* string1 = Shared::Classes::cast<Value, StringValue>(value1.getPointer());
+    StringValue* string2 = Shared::Classes::cast<Value, StringValue>(value2.getPointer());
+
+    // different interned strings have different content
+    if (string1->getIsInterned() && string2->getIsInterned()) return false;
+    // lengths are known without flattening
+    if (string1->getLength() != string2->getLength()) return false;
+    // different cached hashes prove the strings are different
+    if (string1->hasCachedHash() && string2->hasCachedHash() && string1->getHash() != string2->getHash()) return false;
+    return string1->getData() == string2->getData();
   }
 
-  bool getBoolean(Value* value) {
-    if (Shared::Classes::isInstanceOf<Value, NullValue>(value)) return false;
-    if (Shared::Classes::isInstanceOf<Value, BooleanValue>(value)) return BooleanValue::getDataOf(value);
-    if (Shared::Classes::isInstanceOf<Value, NumberValue>(value)) return NumberValue::getDataOf(value) != NUMBER_DEFAULT_VALUE;
-    if (Shared::Classes::isInstanceOf<Value, StringValue>(value)) return StringValue::getDataOf(value) != STRING_DEFAULT_VALUE;
-    if (Shared::Classes::isInstanceOf<Value, CompoundValue>(value)) return true;
+  size_t hashValue(TaggedValue value) {
+    uint64_t bits;
+
+    if (value.isNumber()) {
+      // zeros are equal numbers with different bits
+      double number = value.getNumber();
+      if (number == 0) number = 0;
+      std::memcpy(&bits, &number, sizeof(double));
+    } else if (value.isPointer() && value.getType() == DataType::String) {
+      return Shared::Classes::cast<Value, StringValue>(value.getPointer())->getHash();
+    } else {
+      // null, booleans and references are hashed by identity
+      std::memcpy(&bits, &value, sizeof(TaggedValue));
+    }
+
+    // bits are mixed, so close numbers and aligned pointers are spread over table slots
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    bits *= 0xc4ceb9fe1a85ec53ULL;
+    bits ^= bits >> 33;
+
+    return bits;
+  }
+
+  bool getBoolean(TaggedValue value) {
+    if (value.isNull()) return false;
+    if (value.isBoolean()) return value.getBoolean();
+    if (value.isNumber()) return value.getNumber() != NUMBER_DEFAULT_VALUE;
+    if (value.getType() == DataType::String) return Shared::Classes::cast<Value, StringValue>(value.getPointer())->getLength() != STRING_DEFAULT_VALUE.size();
+    if (Shared::Classes::isInstanceOf<Value, CompoundValue>(value.getPointer())) return true;
     return false;
   }
 
   bool isInstanceOf(Value* superItem, Value* validatingItem) {
-    if (compareValues(superItem, validatingItem)) return true;
+    if (superItem == validatingItem) return true;
+    if (!Shared::Classes::isInstanceOf<Value, ClassValue>(superItem)) return false;
 
-    if (Shared::Classes::isInstanceOf<Value, ClassValue>(validatingItem)) {
-      ClassValue* casted = Shared::Classes::cast<Value, ClassValue>(validatingItem);
+    ClassValue* superClass = Shared::Classes::cast<Value, ClassValue>(superItem);
 
-      for (int i = 0; i < casted->getParents().size(); i++) {
-        if (isInstanceOf(superItem, casted->getParents()[i])) {
-          return true;
-        }
-      }
+    // ancestors are precomputed, so hierarchy is not walked
+    if (Shared::Classes::isInstanceOf<Value, ClassValue>(validatingItem)) {
+      return Shared::Classes::cast<Value, ClassValue>(validatingItem)->hasAncestor(superClass);
     }
 
     if (Shared::Classes::isInstanceOf<Value, ObjectValue>(validatingItem)) {
-      ObjectValue* casted = Shared::Classes::cast<Value, ObjectValue>(validatingItem);
-      return isInstanceOf(superItem, casted->getConstructor());
+      ClassValue* constructor = Shared::Classes::cast<Value, ObjectValue>(validatingItem)->getConstructor();
+      return constructor != NULL && constructor->hasAncestor(superClass);
     }
 
     return false;
@@ -1,40 +1,51 @@
 #pragma once
 
+#include "runtime/arrays.h"
 #include "runtime/stack.h"
-
+#include "runtime/references.h"
+#include "runtime/strings.h"
+#include "runtime/tables.h"
+#include "runtime/tagged.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <functional>
 
+// forward declarations (from parser/ast.h)
+namespace AST {
+  class Expression;
+  class BlockStatement;
+}
+
 // defines how language stores data in runtime
 // adds typing and classes
 // memory is freed by the stack and scope
 namespace Runtime {
-  // define all possible data types
-  enum class DataType {
-    Null,
-    Boolean,
-    Number,
-    String,
-
-    Vector,
-    Object,
-    
-    Function,
-    Class,
-  };
-
   // predefine classes for data types
   class Value;
-  class NullValue;
-  class BooleanValue;
-  class NumberValue;
   class StringValue;
   class VectorValue;
   class ObjectValue;
+  class MapValue;
+  class SetValue;
+  class Float64ArrayValue;
+  class Int64ArrayValue;
   class ClassValue;
   class FunctionValue;
 
+  // builtin functions use memory to retain values they store (from runtime/memory.h)
+  class Memory;
+
+  // predefine object layouts (from runtime/shapes.h)
+  class Shape;
+  class FieldDescriptor;
+
   // default values
   inline const bool BOOLEAN_DEFAULT_VALUE = false;
   inline const double NUMBER_DEFAULT_VALUE = 0;
@@ -65,8 +76,8 @@ namespace Runtime {
       ClassValue* classOwner;
       Value* objectOwner;
 
-      Value* key;
-      Value* value;
+      TaggedValue key;
+      TaggedValue value;
 
     public: 
       Field(
@@ -77,24 +88,25 @@ namespace Runtime {
         ClassValue* classOwner,
         Value* objectOwner, 
       
-        Value* key, 
-        Value* value
+        TaggedValue key, 
+        TaggedValue value
       );
       
-      FieldAccess getAccess();
-      FieldType getType();
-      FieldMutability getMutability();
+      FieldAccess getAccess() const;
+      FieldType getType() const;
+      FieldMutability getMutability() const;
 
-      ClassValue* getClassOwner();
-      Value* getObjectOwner();
+      ClassValue* getClassOwner() const;
+      Value* getObjectOwner() const;
       
-      Value* getKey();
-      Value* getValue();
-      void setValue(Value*);
+      TaggedValue getKey() const;
+      TaggedValue getValue() const;
+      void setValue(TaggedValue);
   };
 
   // root for value hierarchy
-  class Value {
+  // value is reference counted: containers and compound values hold references to values
+  class Value: public ReferenceCounted {
     public:
       // makes hierarchy polymorphic
       virtual ~Value() = default;
@@ -103,60 +115,50 @@ namespace Runtime {
   };
 
   // define primitive types
-  // wraps primitive data and is constant value
+  // null, booleans and numbers are not allocated and are stored in tagged values
   // primitive data types are copied-by-value (cloned)
   class PrimitiveValue: public Value {};
   
-  class NullValue: public PrimitiveValue {
-    public:
-      NullValue();
-
-      DataType getType();
-  };
-  class BooleanValue: public PrimitiveValue {
-    private:
-      bool data;
-
-    public:
-      BooleanValue(bool);
-      BooleanValue(const BooleanValue&);
-
-      DataType getType();
-
-      bool getData();
-      void setData(bool);
-
-      static bool getDataOf(Value*);
-  };
-  class NumberValue: public PrimitiveValue {
-    private:
-      double data;
-
-    public:
-      NumberValue(double);
-      NumberValue(const NumberValue&);
-
-      DataType getType();
-
-      double getData();
-      void setData(double);
-
-      static double getDataOf(Value*);
-  };
+  // characters are stored in a rope of shared immutable chunks
+  // concatenation links ropes, the rope is flattened when contiguous data is needed
+  // strings are passed by views and are copied only when they are modified
+  // slices view ranges of parent chunks and can be compacted to release the parent
   class StringValue: public PrimitiveValue {
     private:
-      std::string data;
+      std::shared_ptr<StringRope> rope;
+      // interned strings are unique by content, so they are compared by pointer
+      bool isInterned;
 
     public:
       StringValue(std::string data);
+      StringValue(std::shared_ptr<StringRope> rope);
       StringValue(const StringValue&);
 
       DataType getType();
 
-      std::string getData();
+      // flattens the rope
+      // view is valid until the string is modified
+      std::string_view getData();
       void setData(std::string);
 
-      static std::string getDataOf(Value*);
+      size_t getLength();
+      // hash of characters is cached until the string is modified
+      size_t getHash();
+      bool hasCachedHash();
+
+      // returns rope of range of characters (is not validated)
+      std::shared_ptr<StringRope> getSlice(size_t offset, size_t length);
+      // copies viewed characters to own chunk
+      void compact();
+
+      bool getIsInterned();
+      void setIsInterned(bool);
+      std::shared_ptr<StringRope> getRope();
+
+      // extends string in place (only for uniquely referenced strings)
+      void append(StringValue*);
+
+      static std::string_view getDataOf(TaggedValue);
   };
 
   // define compound types
@@ -165,79 +167,230 @@ namespace Runtime {
   class CompoundValue: public Value {};
 
   // defines sequence of values
+  // element kinds of vectors
+  // vector of numbers keeps them packed as doubles, the first other item moves it to generic kind
+  // kind is never changed back, so vector does not flip between layouts
+  enum class VectorKind {
+    Numbers,
+    Generic,
+  };
+
   class VectorValue: public CompoundValue {
     private:
-      std::vector<Value*> items;
+      VectorKind kind;
+      // items of numbers vector
+      std::vector<double> numbers;
+      // items of generic vector
+      std::vector<TaggedValue> items;
+
+      // moves numbers to tagged items
+      void convertToGeneric();
 
     public:
-      VectorValue(std::vector<Value*> items);
+      VectorValue(std::vector<TaggedValue> items);
 
       DataType getType();
+      VectorKind getKind();
 
       // fundamental methods
-      std::vector<Value*> getItems();
-      void setItem(int, Value*);
-
-      void push(Value*);
-      Value* pop();
+      // items are exposed read-only, mutations go through vector methods
+      // numbers vector has no tagged items (it refers to no values), its items are exposed as doubles
+      const std::vector<TaggedValue>& getItems();
+      const std::vector<double>& getNumbers();
+      int getSize();
+      TaggedValue getItem(int);
+      void setItem(int, TaggedValue);
+
+      void push(TaggedValue);
+      TaggedValue pop();
+      // bulk methods
+      void reserve(int);
+      void append(const std::vector<TaggedValue>&);
   };
 
+  // objects that get more entries than this are moved to dictionary mode
+  inline const int OBJECT_DICTIONARY_THRESHOLD = 8;
+
   // defines associations or maps
   // objects have public instance fields
+  // keys and metadata of entries are held by shared shape, object holds only values
+  // large objects are stored in dictionary mode: object owns descriptors and a table of key slots
   class ObjectValue: public CompoundValue {
     private:
       // contains NULL for plain objects
       ClassValue* constructor;
-      std::vector<Field> entries;
+      // contains NULL in dictionary mode
+      Shape* shape;
+      // values by slots of shape
+      std::vector<TaggedValue> values;
+
+      // contains NULL in shape mode
+      // maps keys to slots (as numbers), descriptors are indexed by slots
+      HashTable* dictionary;
+      std::vector<FieldDescriptor> dictionaryDescriptors;
 
     public:
-      ObjectValue(ClassValue* constructor, std::vector<Field> entries);
+      ObjectValue(ClassValue* constructor, Shape* shape, std::vector<TaggedValue> values);
+      ~ObjectValue();
 
       DataType getType();
 
       ClassValue* getConstructor();
+      Shape* getShape();
+
+      // dictionary objects have no shared layout, so their member access is not cached
+      bool getIsDictionary();
+      // moves entries from shape to own table
+      void convertToDictionary();
 
-      std::vector<Field> getEntries();
-      Value* getEntryValue(Value*);
+      // slots are not validated
+      const std::vector<TaggedValue>& getValues();
+      TaggedValue getValue(int slot);
+      void setValue(int slot, TaggedValue);
 
-      // return if the field is added
-      bool addField(Field);
+      // returns slot of entry or SHAPE_SLOT_NOT_FOUND
+      int findSlot(TaggedValue key);
+      const FieldDescriptor& getDescriptor(int slot);
+
+      // returns null if no entry is found
+      TaggedValue getEntryValue(TaggedValue);
+
+      // return if the field is added (object moves to child shape)
+      bool addField(const FieldDescriptor&, TaggedValue);
 
       // return if the entry is set
-      bool setEntry(Value*, Value*);
+      bool setEntry(TaggedValue, TaggedValue);
       
-      bool hasEntry(Value*);
+      bool hasEntry(TaggedValue);
+  };
+
+  // defines hash map of values
+  // keys are compared as values (strings by characters), compound keys by reference
+  // keys and values are retained by the code that stores them
+  class MapValue: public CompoundValue {
+    private:
+      HashTable table;
+
+    public:
+      MapValue();
+
+      DataType getType();
+
+      HashTable& getTable();
+  };
+
+  // defines hash set of values (entries have null values)
+  class SetValue: public CompoundValue {
+    private:
+      HashTable table;
+
+    public:
+      SetValue();
+
+      DataType getType();
+
+      HashTable& getTable();
   };
 
+  // define typed arrays
+  // numbers are stored unboxed in aligned memory and are processed by vectorized kernels
+  // arrays have fixed size and do not refer to other values
+  class Float64ArrayValue: public CompoundValue {
+    private:
+      AlignedArray<double> items;
+
+    public:
+      Float64ArrayValue(int size);
+
+      DataType getType();
+
+      AlignedArray<double>& getItems();
+  };
+
+  // items are converted to numbers when they are read, so values above 2^53 lose precision
+  class Int64ArrayValue: public CompoundValue {
+    private:
+      AlignedArray<int64_t> items;
+
+    public:
+      Int64ArrayValue(int size);
+
+      DataType getType();
+
+      AlignedArray<int64_t>& getItems();
+  };
+
+  // returned by class tables if field is not found
+  inline const int FIELD_SLOT_NOT_FOUND = -1;
+
   class ClassValue: public CompoundValue {
     private:
+      // serial number of the class
+      // addresses of released classes are reused, identities are not
+      uint64_t identity;
+
       // for inheritance
       // multiple inheritance is allowed
       std::vector<ClassValue*> parents;
       // list of data members
+      // contains own fields and inherited fields that are not overridden
       std::vector<Field> fields;
 
+      // precomputed at declaration, so hierarchy is not walked by lookups
+      // method resolution order (C3), starts with the class itself
+      std::vector<ClassValue*> linearization;
+      // all the classes of linearization
+      std::unordered_set<ClassValue*> ancestors;
+      // slots of fields by interned keys
+      std::unordered_map<Value*, int> staticSlots;
+      std::unordered_map<Value*, int> instanceSlots;
+
       // constructor and destructor 
       FunctionValue* constructor;
       FunctionValue* destructor;
 
+      int findSlot(const std::unordered_map<Value*, int>&, FieldType, TaggedValue);
+
     public:
+      // linearization of parents is computed by linearizeParents
       ClassValue(
         std::vector<ClassValue*> parents, 
-        std::vector<Field> fields,
+        std::vector<ClassValue*> parentsLinearization,
         FunctionValue* constructor,
         FunctionValue* destructor
       );
 
       DataType getType();
 
-      std::vector<ClassValue*> getParents();      
-      std::vector<Field> getFields();
+      // identifies the class in inline caches (0 is never given)
+      uint64_t getIdentity();
+
+      const std::vector<ClassValue*>& getParents();
+      const std::vector<Field>& getFields();
+      const std::vector<ClassValue*>& getLinearization();
+
+      FunctionValue* getConstructor();
+      FunctionValue* getDestructor();
+
+      // own fields are declared once after class is created (fields refer to class as owner)
+      // inherited fields are flattened to fields list by linearization order
+      void setFields(std::vector<Field>);
+
+      // returns slot in fields list or FIELD_SLOT_NOT_FOUND
+      int findStaticSlot(TaggedValue key);
+      int findInstanceSlot(TaggedValue key);
+
+      // checks if class is the class itself or its ancestor
+      bool hasAncestor(ClassValue*);
   };
 
+  // merges linearizations of parents with C3 algorithm
+  // returns nullopt if the order of parents is inconsistent
+  std::optional<std::vector<ClassValue*>> linearizeParents(const std::vector<ClassValue*>& parents);
+
   // define function value
   // define function callable type
-  using Callable = std::function<Value*(std::vector<Value*>)>;
+  using Callable = std::function<TaggedValue(Memory&, std::vector<TaggedValue>)>;
 
   // function arguments controller
   class FunctionArgumentsAmount {
@@ -253,18 +406,41 @@ namespace Runtime {
       int getOptionalArgumentsAmount();
   };
 
+  // script function parameter metadata
+  class FunctionParameter {
+    private:
+      std::string name;
+      // NULL if no default value
+      AST::Expression* defaultValue;
+
+    public:
+      FunctionParameter(std::string name, AST::Expression* defaultValue);
+
+      const std::string& getName() const;
+      AST::Expression* getDefaultValue() const;
+  };
+
   // function value
+  // script functions are executed directly by interpreter (body and parameters)
+  // builtin functions are executed indirectly (callable)
   class FunctionValue: public CompoundValue {
     private:
       // copy of the stack at the moment of declaration
       Stack* closure;
       // context is used to define this for methods (NULL for functions)
       Value* context;
+      // script function body (NULL for builtin functions)
+      AST::BlockStatement* body;
+      std::vector<FunctionParameter> parameters;
+      // builtin function callable (empty for script functions)
       Callable callable;
       // controls amount of arguments
       FunctionArgumentsAmount argumentsAmount;
 
     public:
+      // script function
+      FunctionValue(Stack*, Value*, AST::BlockStatement*, std::vector<FunctionParameter>, FunctionArgumentsAmount);
+      // builtin function
       FunctionValue(Stack*, Value*, Callable, FunctionArgumentsAmount);
       ~FunctionValue();
 
@@ -272,8 +448,16 @@ namespace Runtime {
 
       Stack* getClosure();
       Value* getContext();
-      Value* execute(std::vector<Value*>); 
       FunctionArgumentsAmount getArgumentsAmount();
+
+      bool isBuiltin();
+
+      // script function execution data
+      AST::BlockStatement* getBody();
+      const std::vector<FunctionParameter>& getParameters();
+
+      // builtin function execution
+      TaggedValue execute(Memory&, std::vector<TaggedValue>); 
   };
 
   // fundamental utilities
@@ -281,10 +465,13 @@ namespace Runtime {
   // compares two values 
   // primitive values are compared by value and by reference
   // compound values are compared only by reference and considered non-equal if references are different
-  bool compareValues(Value*, Value*);
+  bool compareValues(TaggedValue, TaggedValue);
+  // hash that is consistent with compareValues (equal values have equal hashes)
+  // string hashes are cached by strings
+  size_t hashValue(TaggedValue);
 
   // evaluate value a bool
-  bool getBoolean(Value*);
+  bool getBoolean(TaggedValue);
 
   bool isInstanceOf(Value* superItem, Value* validatingItem);
 } 